@@ -2,6 +2,7 @@
 #define __DAG_HPP__
 
 #include "common.hpp"
+#include "job_stream.hpp"
 
 class DAG
 {
@@ -28,6 +29,13 @@ public:
         return count.empty();
     }
 
+    // number of unfinished tasks
+    //  including running ones
+    int taskSize()
+    {
+        return count.size();
+    }
+
     void updateDAG(vector<pair<string, double>> finished_tasks)
     {
         int size = finished_tasks.size();
@@ -60,14 +68,42 @@ public:
         return ret;
     }
 
+    // copy of DAG on a fork of graph
+    // note: member DAG hides the class name
+    class DAG fork(shared_ptr<Graph> fork_graph) const
+    {
+        class DAG ret = *this;
+        ret.graph = fork_graph;
+        return ret;
+    }
+
+    // insert a newly arrived job
+    //  its source tasks can be submit at once
+    void addJob(const JobArrival &job)
+    {
+        vector<string> tasks;
+        for (const auto &task : job.job["task"])
+            tasks.push_back(task["name"]);
+        for (const auto &task : tasks)
+            count[task] = 0;
+        for (const auto &iter : job.constraint)
+        {
+            count[iter.second]++;
+            DAG[iter.first].insert(iter.second);
+        }
+        for (const auto &task : tasks)
+            if (count[task] == 0)
+                queue.insert(task);
+    }
+
     void init(shared_ptr<Graph> outergraph)
     {
         this->graph = outergraph;
-        for (const auto &iter : graph->require)
+        for (const auto &iter : graph->workload->require)
         {
             count[iter.first] = 0;
         }
-        for (const auto &iter : graph->constraint)
+        for (const auto &iter : graph->workload->constraint)
         {
             count[iter.second]++;
             DAG[iter.first].insert(iter.second);
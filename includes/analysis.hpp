@@ -0,0 +1,134 @@
+#ifndef __ANALYSIS_HPP__
+#define __ANALYSIS_HPP__
+
+#include "common.hpp"
+
+// lower bounds of any schedule of the loaded jobs
+//
+// a task holds a slot for at least
+//  its least transfer time over DCs plus run_time
+//  (outputs of prev tasks may be on the same DC, so cost 0)
+// so makespan is at least
+//  total work / total slots
+//  and arrival + critical path of every job,
+//  the longest chain of such times in the job
+struct ScheduleBound
+{
+    // sum of least slot time of tasks
+    double total_work = 0;
+    // max of arrival + critical path over jobs
+    double path_bound = 0;
+    // longest critical path
+    double max_path = 0;
+    int jobs = 0;
+
+    double makespan(int total_slots) const
+    {
+        double work = total_slots > 0 ? total_work / total_slots : 0;
+        return std::max(work, path_bound);
+    }
+};
+
+// least transfer time of task over DCs it fits in
+//  only inputs already located are counted
+double min_transfer(shared_ptr<Graph> graph, const string &task)
+{
+    double ret = std::numeric_limits<double>::max();
+    for (const auto &slot : graph->slots)
+        if (slot.second.first > 0 && graph->workload->fits(task, slot.first))
+            ret = std::min(ret, graph->transferTime(task, slot.first));
+    return ret == std::numeric_limits<double>::max() ? 0 : ret;
+}
+
+// add unfinished jobs not analyzed to bound
+//  call once after init_data(), or after jobs arrive
+// critical path of job is put into graph->job_path,
+//  so slowdown in graph->stats is over it
+// O(tasks * DCs + constraints) with Kahn's algorithm
+void analyze_jobs(shared_ptr<Graph> graph, ScheduleBound &bound)
+{
+    const Workload &work = *graph->workload;
+    for (const auto &job : graph->job_task)
+    {
+        const auto &tasks = job.second;
+        if (tasks.empty() ||
+            graph->job_path.find(job.first) != graph->job_path.end())
+            continue;
+
+        // e.g. {"tA3",2}
+        //  tA3 waits for 2 tasks of this job
+        unordered_map<string, int> in_degree;
+        // e.g. {"tA3",7}
+        //  chains ending at tA3 take 7s at least
+        unordered_map<string, double> finish;
+        vector<string> order;
+        for (const auto &task : tasks)
+        {
+            int cnt = 0;
+            auto prev = work.prev_nodes.find(task);
+            if (prev != work.prev_nodes.end())
+                for (const auto &it : prev->second)
+                    cnt += tasks.count(it);
+            in_degree[task] = cnt;
+            if (cnt == 0)
+                order.push_back(task);
+        }
+
+        double path = 0;
+        for (int i = 0; i < order.size(); ++i)
+        {
+            const string &task = order[i];
+            double cost = min_transfer(graph, task) + work.run_time.at(task);
+            bound.total_work += cost;
+            double &f = finish[task];
+            f += cost;
+            path = std::max(path, f);
+            auto next = work.next_nodes.find(task);
+            if (next == work.next_nodes.end())
+                continue;
+            for (const auto &it : next->second)
+            {
+                auto iter = in_degree.find(it);
+                if (iter == in_degree.end())
+                    continue;
+                finish[it] = std::max(finish[it], f);
+                if (--iter->second == 0)
+                    order.push_back(it);
+            }
+        }
+        if (order.size() != tasks.size())
+            printWarning("Cycle in Job " + job.first);
+
+        auto arrival = work.arrival.find(job.first);
+        double start = arrival == work.arrival.end() ? 0 : arrival->second;
+        bound.path_bound = std::max(bound.path_bound, start + path);
+        bound.max_path = std::max(bound.max_path, path);
+        bound.jobs++;
+        graph->job_path[job.first] = path;
+    }
+}
+
+ScheduleBound analyze_bound(shared_ptr<Graph> graph)
+{
+    ScheduleBound bound;
+    analyze_jobs(graph, bound);
+    return bound;
+}
+
+// compare makespan of a finished run with bound
+void print_bound(shared_ptr<Graph> graph, const ScheduleBound &bound,
+                 double makespan)
+{
+    int total_slots = graph->totalSlots();
+    double lower = bound.makespan(total_slots);
+    std::cout << "LOWER BOUND: " << lower << ' '
+              << "WORK: " << (total_slots > 0 ? bound.total_work / total_slots
+                                              : 0)
+              << ' '
+              << "PATH: " << bound.path_bound << '\n'
+              << "GAP: " << (lower > 0 ? makespan / lower : 0) << ' '
+              << "SLOWDOWN MAX: " << graph->stats.slowdown.quantile(1)
+              << std::endl;
+}
+
+#endif
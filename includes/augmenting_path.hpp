@@ -0,0 +1,214 @@
+#ifndef __AUGMENTING_PATH_HPP__
+#define __AUGMENTING_PATH_HPP__
+
+#include "common.hpp"
+
+// pairing heap of nodes keyed by distance, with decrease-key
+//  node arrays are kept between uses, so no allocation after init()
+class PairingHeap
+{
+private:
+    vector<double> key;
+    // first child, next sibling, and parent or previous sibling
+    vector<int> child, sibling, prev;
+    // children of popped root, merged in two passes
+    vector<int> roots;
+    int root;
+
+    int meld(int a, int b)
+    {
+        if (key[b] < key[a])
+            std::swap(a, b);
+        // b becomes first child of a
+        sibling[b] = child[a];
+        if (~child[a])
+            prev[child[a]] = b;
+        prev[b] = a;
+        child[a] = b;
+        return a;
+    }
+
+public:
+    void init(int n)
+    {
+        key.resize(n);
+        child.resize(n);
+        sibling.resize(n);
+        prev.resize(n);
+        root = -1;
+    }
+
+    bool empty() const
+    {
+        return root == -1;
+    }
+
+    void clear()
+    {
+        root = -1;
+    }
+
+    void push(int x, double k)
+    {
+        key[x] = k;
+        child[x] = sibling[x] = prev[x] = -1;
+        root = root == -1 ? x : meld(root, x);
+    }
+
+    // k is not larger than key of x
+    void decrease(int x, double k)
+    {
+        key[x] = k;
+        if (x == root)
+            return;
+        // cut x with its subtree
+        if (child[prev[x]] == x)
+            child[prev[x]] = sibling[x];
+        else
+            sibling[prev[x]] = sibling[x];
+        if (~sibling[x])
+            prev[sibling[x]] = prev[x];
+        sibling[x] = prev[x] = -1;
+        root = meld(root, x);
+    }
+
+    int pop()
+    {
+        int ret = root;
+        roots.clear();
+        for (int x = child[ret]; ~x; x = sibling[x])
+            roots.push_back(x);
+        if (roots.empty())
+        {
+            root = -1;
+            return ret;
+        }
+        for (int x : roots)
+            prev[x] = sibling[x] = -1;
+        // left to right in pairs, then right to left
+        int cnt = 0;
+        for (int i = 0; i + 1 < roots.size(); i += 2)
+            roots[cnt++] = meld(roots[i], roots[i + 1]);
+        if (roots.size() % 2)
+            roots[cnt++] = roots.back();
+        root = roots[cnt - 1];
+        for (int i = cnt - 2; i >= 0; --i)
+            root = meld(roots[i], root);
+        return ret;
+    }
+};
+
+// successive shortest augmenting paths of min cost max flow
+//  shared by NetworkSum and NetworkNeck
+//
+// Dijkstra over reduced costs cost + pot[u] - pot[v],
+//  pot[v] += min(dis[v], dis[sink]) after each path,
+//  so reduced costs stay >= 0 and the search stops at sink
+// costs of a network must be >= 0 at first
+// edges are the network's: head list, next, v, cap, i^1 is reversed
+// buffers are kept between paths, so no allocation after init()
+template <class Edge>
+class AugmentingPath
+{
+private:
+    static constexpr double INF = std::numeric_limits<double>::max();
+
+    int source, sink;
+    vector<double> pot, dis;
+    // capacity of path to node
+    vector<int> cap;
+    // edge id into node
+    vector<int> prev;
+    // 0: not reached, 1: in heap, 2: done
+    vector<char> state;
+    PairingHeap heap;
+
+public:
+    void init(int nodes, int source, int sink)
+    {
+        this->source = source;
+        this->sink = sink;
+        pot.assign(nodes, 0);
+        dis.resize(nodes);
+        cap.resize(nodes);
+        prev.resize(nodes);
+        state.resize(nodes);
+        heap.init(nodes);
+    }
+
+    // find shortest path to sink in residual network
+    //  return its capacity, 0 if sink is not reachable
+    // cost is the member of Edge holding cost
+    int find(const vector<int> &head, const vector<Edge> &edges,
+             double Edge::*cost)
+    {
+        std::fill(dis.begin(), dis.end(), INF);
+        std::fill(state.begin(), state.end(), 0);
+        heap.clear();
+        dis[source] = 0;
+        cap[source] = std::numeric_limits<int>::max();
+        state[source] = 1;
+        heap.push(source, 0);
+
+        while (!heap.empty())
+        {
+            int x = heap.pop();
+            state[x] = 2;
+            if (x == sink)
+                break;
+            for (int i = head[x]; ~i; i = edges[i].next)
+            {
+                int to = edges[i].v;
+                if (edges[i].cap <= 0 || state[to] == 2)
+                    continue;
+                // >= 0 up to rounding
+                double reduced = std::max(
+                    0.0, edges[i].*cost + pot[x] - pot[to]);
+                double d = dis[x] + reduced;
+                if (d < dis[to])
+                {
+                    dis[to] = d;
+                    prev[to] = i;
+                    cap[to] = std::min(cap[x], edges[i].cap);
+                    if (state[to] == 1)
+                        heap.decrease(to, d);
+                    else
+                        state[to] = 1, heap.push(to, d);
+                }
+            }
+        }
+        if (state[sink] != 2)
+            return 0;
+
+        for (int x = 0; x < pot.size(); ++x)
+            pot[x] += std::min(dis[x], dis[sink]);
+        return cap[sink];
+    }
+
+    // push flow along path found by find()
+    void augment(vector<Edge> &edges, int flow)
+    {
+        for (int i = sink; i != source;
+             i = edges[prev[i] ^ 1].v)
+        {
+            edges[prev[i]].cap -= flow;
+            edges[prev[i] ^ 1].cap += flow;
+        }
+    }
+
+    // augment until sink is not reachable
+    //  return total flow
+    int minCostFlow(const vector<int> &head, vector<Edge> &edges,
+                    double Edge::*cost)
+    {
+        int ret = 0, new_flow;
+        while ((new_flow = find(head, edges, cost)))
+        {
+            ret += new_flow;
+            augment(edges, new_flow);
+        }
+        return ret;
+    }
+};
+
+#endif
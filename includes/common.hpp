@@ -17,6 +17,12 @@
 #include <cmath>
 #include <random>
 #include "json.hpp"
+#include "output.hpp"
+#include "rng.hpp"
+#include "histogram.hpp"
+#include "output_loc.hpp"
+#include "widest_path.hpp"
+#include "pair_flow.hpp"
 
 using json = nlohmann::json;
 using std::make_pair;
@@ -36,12 +42,36 @@ using std::vector;
 static const string DIR = "./";
 // static const string DIR = "./scripts/";
 
+// default random stream
+//  reseed it with seedRandom() for reproducible runs
+Rng &globalRng()
+{
+    static Rng gen(time(0));
+    return gen;
+}
+
+void seedRandom(uint64_t seed)
+{
+    globalRng().seed(seed);
+}
+
 // uniformly random int in [mn, mx]
 int randInt(int mn, int mx)
 {
-    static std::mt19937 gen(time(0));
-    std::uniform_int_distribution<int> dis(mn, mx);
-    return dis(gen);
+    return globalRng().randInt(mn, mx);
+}
+
+// read "seed replication" from seed.txt
+// e.g. "42 3"
+//  replication 3 of an experiment with seed 42
+// seed is time(0) if there is no seed.txt
+pair<uint64_t, uint64_t> readSeed()
+{
+    uint64_t seed = time(0), replication = 0;
+    std::ifstream fin(DIR + "seed.txt");
+    if (fin.is_open())
+        fin >> seed >> replication;
+    return make_pair(seed, replication);
 }
 
 // print error message and terminate
@@ -57,7 +87,59 @@ void printWarning(string msg)
     std::cout << "Warning: " << msg << std::endl;
 }
 
-struct Graph
+// running statistics of job completion time
+//  so finished jobs need not be kept
+struct JobStats
+{
+    long long cnt;
+    double mean, m2, mx;
+
+    // quantiles of completion time
+    LogHistogram jct;
+    // completion time over critical path of job
+    LogHistogram slowdown;
+    double slowdown_sum;
+
+    // wall time spent in Scheduler::getScheduled()
+    double sched_time;
+    long long rounds;
+
+    JobStats() : cnt(0), mean(0), m2(0), mx(0), slowdown_sum(0),
+                 sched_time(0), rounds(0) {}
+
+    // Welford's online algorithm
+    void add(double x)
+    {
+        cnt++;
+        double delta = x - mean;
+        mean += delta / cnt;
+        m2 += delta * (x - mean);
+        mx = std::max(mx, x);
+        jct.add(x);
+    }
+
+    void addSlowdown(double x)
+    {
+        slowdown.add(x);
+        slowdown_sum += x;
+    }
+
+    double slowdownMean()
+    {
+        return slowdown.count() == 0 ? 0 : slowdown_sum / slowdown.count();
+    }
+
+    double stddev()
+    {
+        return cnt == 0 ? 0 : std::sqrt(m2 / cnt);
+    }
+};
+
+// workload of a run: tasks, resources and network
+//  shared by all forks of a Graph, which never change it
+// note: readers use find() or at(),
+//  so forks may read it from different threads
+struct Workload
 {
     // e.g. {"tA3",{"tA1","tA2"}}
     //  tA3 needs the results of tA1 or tA2
@@ -72,16 +154,10 @@ struct Graph
     //  "tA1" belongs to "A"
     unordered_map<string, string> which_job;
 
-    // task's (start_time,run_time)
-    map<string, pair<double, double>> task_span;
-
-    // job's finish time
-    map<string, double> finish_time;
-
-    // task set of each job
-    // e.g {"A",{"tA1","tA2"}}
-    //  job "A" has two tasks "tA1" and "tA2"
-    unordered_map<string, unordered_set<string>> job_task;
+    // job's arrival time, 0 if absent
+    // e.g. {"A",3.5}
+    //  job A is submitted at 3.5s
+    unordered_map<string, double> arrival;
 
     // e.g, {"tB1","tB2"}
     //  tB2 need the result of tB1
@@ -104,13 +180,130 @@ struct Graph
     //  resource A1 is put in DC1
     unordered_map<string, string> resource_loc;
 
+    // extra copies of resource "xx", see replication.hpp
+    // e.g. replica_loc["A1"]={"DC3"}
+    //  A1 is also put in DC3
+    unordered_map<string, vector<string>> replica_loc;
+
     // adjacent matrix
     // e.g. edges["DC1"]["DC2"]=1/100
     //  if bandwidth between DC1 and DC2 is 100
+    // note: it is of widest paths, see set_bandwidth(),
+    //  or of max flows if multipath, see use_multipath()
     unordered_map<string,
                   unordered_map<string, double>>
         edges;
 
+    // direct links in link.json and widest paths over them
+    //  edges is a copy of paths.dis by name
+    WidestPaths paths;
+
+    // bandwidth of direct links, -1 if down
+    // e.g. bandwidth["DC1"]["DC2"]=100
+    unordered_map<string,
+                  unordered_map<string, double>>
+        bandwidth;
+
+    // a transfer is striped over all paths between DCs
+    //  threads computing max flows, 0 for all cores
+    bool multipath = false;
+    int flow_threads = 0;
+    // pairs solved by max flow last time
+    long long flows_solved = 0;
+
+    // names of resource dimensions
+    // e.g. {"cpu","mem"}
+    vector<string> dims;
+
+    // task's demand of each dimension
+    //  absent if the task only takes a slot
+    // e.g. demand["tA1"]={2,4}
+    //  tA1 takes 2 cpu and 4 mem
+    unordered_map<string, vector<double>> demand;
+
+    // DC's capacity of each dimension
+    //  absent if unlimited
+    // e.g. capacity["DC1"]={16,64}
+    unordered_map<string, vector<double>> capacity;
+
+    // index of dimension name, added if new
+    int dimId(const string &name)
+    {
+        auto iter = std::find(dims.begin(), dims.end(), name);
+        if (iter != dims.end())
+            return iter - dims.begin();
+        dims.push_back(name);
+        return dims.size() - 1;
+    }
+
+    // whether demand of task fits in DC
+    //  besides used and extra, empty if DC is idle
+    bool fits(const string &task, const string &DC,
+              const vector<double> &used = vector<double>(),
+              const vector<double> &extra = vector<double>()) const
+    {
+        auto need = demand.find(task);
+        if (need == demand.end())
+            return true;
+        auto cap = capacity.find(DC);
+        if (cap == capacity.end())
+            return true;
+        for (int k = 0; k < need->second.size() &&
+                        k < cap->second.size();
+             ++k)
+        {
+            double total = need->second[k];
+            if (k < used.size())
+                total += used[k];
+            if (k < extra.size())
+                total += extra[k];
+            if (total > cap->second[k] + 1e-9)
+                return false;
+        }
+        return true;
+    }
+};
+
+// state of a run
+//  fork() copies running tasks and unfinished jobs,
+//  and shares the workload and outputs of finished tasks
+struct Graph
+{
+    shared_ptr<Workload> workload = make_shared<Workload>();
+
+    // task's (start_time,run_time)
+    map<string, pair<double, double>> task_span;
+
+    // job's finish time
+    map<string, double> finish_time;
+
+    // statistics of finished jobs
+    JobStats stats;
+
+    // finished tasks of each unfinished job
+    //  they are retired with the job
+    unordered_map<string, vector<string>> done_task;
+
+    // finished tasks and jobs are streamed to sink
+    //  as they complete
+    shared_ptr<OutputSink> sink;
+
+    // free all states of finished jobs
+    //  keep everything in memory if false
+    bool retire = false;
+
+    // unfinished tasks of each unfinished job
+    // e.g {"A",{"tA1","tA2"}}
+    //  job "A" has two tasks "tA1" and "tA2" left
+    unordered_map<string, unordered_set<string>> job_task;
+
+    // location of intermediate outputs
+    //  a task's output is named after the task
+    //  and stays on the DC it ran on
+    // e.g. *output_loc.find("tA1")=="DC2"
+    //  tA1 ran on DC2, tasks need "tA1" read it from DC2
+    OutputLoc output_loc;
+
     // slots of "DCi"
     // e.g. slots["DC1"]={2,{"tA1"}}
     //  the capacity of DC1 is 2 and tA1 is running
@@ -118,6 +311,259 @@ struct Graph
                   pair<int, unordered_set<string>>>
         slots;
 
+    // demand of running tasks on "DCi"
+    // e.g. usage["DC1"]={2,4}
+    unordered_map<string, vector<double>> usage;
+
+    // static inputs (DC.json) of tasks not ready yet
+    //  staged to a DC since a time, see Simulator::updatePrefetch()
+    // e.g. staged["tA3"]={"DC2",4.5}
+    //  resources of tA3 are sent to DC2 from 4.5s
+    unordered_map<string, pair<string, double>> staged;
+
+    // -----> utilization begin
+    // longest chain of run time ending at finished task
+    //  and longest one of each unfinished job
+    // e.g. path_len["tA3"]=5
+    //  tA3 can not finish in 5s after its job arrives
+    unordered_map<string, double> path_len;
+    unordered_map<string, double> job_path;
+
+    // slot seconds of copies run on DC, cancelled ones included
+    // e.g. busy["DC1"]=30.5
+    unordered_map<string, double> busy;
+    // busy slot seconds of all DCs in each window
+    //  of util_window seconds
+    vector<double> busy_series;
+    double util_window = 10;
+    // last time a slot is freed
+    double last_time = 0;
+    // <----- utilization end
+
+    // task finished at finish_time on DC
+    //  after transfer time of its inputs
+    //  and run seconds of execution, run_time if negative
+    // note: job finishes with its last task
+    void finishTask(const string &task, const string &DC,
+                    double transfer, double finish_time,
+                    double run = -1)
+    {
+        if (run < 0)
+            run = workload->run_time.at(task);
+        output_loc.set(task, DC);
+        if (sink)
+            sink->writeTask(task, DC, finish_time - run,
+                            transfer, run);
+        if (!retire)
+            task_span[task] = make_pair(finish_time - run, run);
+        string job = workload->which_job.at(task);
+        if (retire)
+            done_task[job].push_back(task);
+
+        // all prev tasks are finished
+        double len = 0;
+        auto prev = workload->prev_nodes.find(task);
+        if (prev != workload->prev_nodes.end())
+            for (const auto &it : prev->second)
+            {
+                auto iter = path_len.find(it);
+                if (iter != path_len.end())
+                    len = std::max(len, iter->second);
+            }
+        len += workload->run_time.at(task);
+        path_len[task] = len;
+        job_path[job] = std::max(job_path[job], len);
+
+        auto &tasks = job_task[job];
+        tasks.erase(task);
+        if (tasks.empty())
+            finishJob(job, finish_time);
+    }
+
+    void finishJob(const string &job, double time)
+    {
+        finish_time[job] = time;
+        stats.add(completionTime(job));
+        if (job_path[job] > 0)
+            stats.addSlowdown(completionTime(job) / job_path[job]);
+        job_path.erase(job);
+        job_task.erase(job);
+        if (sink)
+            sink->writeJob(job, time);
+        if (retire)
+            retireJob(job);
+    }
+
+    // free states of finished job and its tasks
+    // note: never retire in a fork, the workload is shared
+    void retireJob(const string &job)
+    {
+        for (const auto &task : done_task[job])
+        {
+            workload->run_time.erase(task);
+            workload->require.erase(task);
+            workload->which_job.erase(task);
+            workload->prev_nodes.erase(task);
+            workload->next_nodes.erase(task);
+            workload->demand.erase(task);
+            output_loc.erase(task);
+            path_len.erase(task);
+        }
+        done_task.erase(job);
+        finish_time.erase(job);
+        workload->arrival.erase(job);
+    }
+
+    // copy running state and share workload
+    //  outputs (task_span, finish_time, sink) are not copied
+    //  and the fork never retires jobs
+    shared_ptr<Graph> fork() const
+    {
+        auto ret = make_shared<Graph>();
+        ret->workload = workload;
+        ret->stats = stats;
+        ret->job_task = job_task;
+        ret->output_loc = output_loc.fork();
+        ret->slots = slots;
+        ret->usage = usage;
+        ret->staged = staged;
+        return ret;
+    }
+
+    // whether demand of task fits in DC
+    //  besides running tasks and extra
+    bool fits(const string &task, const string &DC,
+              const vector<double> &extra = vector<double>()) const
+    {
+        static const vector<double> idle;
+        auto used = usage.find(DC);
+        return workload->fits(task, DC,
+                              used == usage.end() ? idle : used->second,
+                              extra);
+    }
+
+    // total += demand of task * sign
+    void addDemand(vector<double> &total, const string &task,
+                   int sign = 1) const
+    {
+        auto need = workload->demand.find(task);
+        if (need == workload->demand.end())
+            return;
+        if (total.size() < need->second.size())
+            total.resize(need->second.size());
+        for (int k = 0; k < need->second.size(); ++k)
+            total[k] += sign * need->second[k];
+    }
+
+    // how well demand of task matches free capacity of DC
+    //  sum of demand/capacity * free/capacity over dimensions
+    //  0 if either is absent
+    double alignment(const string &task, const string &DC) const
+    {
+        auto need = workload->demand.find(task);
+        if (need == workload->demand.end())
+            return 0;
+        auto cap = workload->capacity.find(DC);
+        if (cap == workload->capacity.end())
+            return 0;
+        auto used = usage.find(DC);
+        double ret = 0;
+        for (int k = 0; k < need->second.size() &&
+                        k < cap->second.size();
+             ++k)
+        {
+            double c = cap->second[k];
+            if (c <= 0 || c == std::numeric_limits<double>::max())
+                continue;
+            double free = c;
+            if (used != usage.end() && k < used->second.size())
+                free -= used->second[k];
+            ret += need->second[k] / c * free / c;
+        }
+        return ret;
+    }
+
+    // where resource is
+    //  static resources in DC.json, or outputs of finished tasks
+    // nullptr if unknown
+    const string *locate(const string &resource) const
+    {
+        auto iter = workload->resource_loc.find(resource);
+        if (iter != workload->resource_loc.end())
+            return &iter->second;
+        return output_loc.find(resource);
+    }
+
+    // DCs task reads inputs from, replicas included
+    //  transferTime() only depends on edges from them
+    vector<string> inputDCs(const string &task) const
+    {
+        vector<string> ret;
+        auto resource_requires = workload->require.find(task);
+        if (resource_requires == workload->require.end())
+            return ret;
+        for (const auto &resource : resource_requires->second)
+        {
+            const string *loc = locate(resource.first);
+            if (!loc)
+                continue;
+            ret.push_back(*loc);
+            auto replicas = workload->replica_loc.find(resource.first);
+            if (replicas != workload->replica_loc.end())
+                ret.insert(ret.end(), replicas->second.begin(),
+                           replicas->second.end());
+        }
+        std::sort(ret.begin(), ret.end());
+        ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+        return ret;
+    }
+
+    // time to transfer size of resource at loc to DC
+    //  read from the nearest replica
+    double inputTime(const string &resource, double size,
+                     const string &loc, const string &DC) const
+    {
+        double bandwidth = workload->edges.at(loc).at(DC);
+        auto replicas = workload->replica_loc.find(resource);
+        if (replicas != workload->replica_loc.end())
+            for (const auto &replica : replicas->second)
+                bandwidth = std::min(bandwidth,
+                                     workload->edges.at(replica).at(DC));
+        return size * bandwidth;
+    }
+
+    // time to transfer all inputs of task to DC
+    //  transfers run in parallel, so the slowest one counts
+    // if now is given and inputs are staged to DC,
+    //  static ones only take what is left at now
+    double transferTime(const string &task, const string &DC,
+                        double now = -1) const
+    {
+        auto resource_requires = workload->require.find(task);
+        if (resource_requires == workload->require.end())
+            return 0;
+        const pair<string, double> *stage = nullptr;
+        if (now >= 0)
+        {
+            auto iter = staged.find(task);
+            if (iter != staged.end() && iter->second.first == DC)
+                stage = &iter->second;
+        }
+        double mx = 0;
+        for (const auto &resource : resource_requires->second)
+        {
+            const string *loc = locate(resource.first);
+            if (!loc)
+                continue;
+            double t = inputTime(resource.first, resource.second, *loc, DC);
+            if (stage && workload->resource_loc.find(resource.first) !=
+                             workload->resource_loc.end())
+                t = std::max(0.0, stage->second + t - now);
+            mx = std::max(mx, t);
+        }
+        return mx;
+    }
+
     void printStatus()
     {
         for (const auto &DC : slots)
@@ -144,7 +590,7 @@ struct Graph
             for (const auto &it : finish_time)
             {
                 std::cout << it.first << ' '
-                          << std::setprecision(4) << it.second << std::endl;
+                          << std::setprecision(4) << it.second << '\n';
             }
         else
         {
@@ -155,7 +601,7 @@ struct Graph
             for (const auto &it : finish_time)
             {
                 fout << it.first << ' '
-                     << std::setprecision(4) << it.second << std::endl;
+                     << std::setprecision(4) << it.second << '\n';
             }
             fout.close();
         }
@@ -176,26 +622,77 @@ struct Graph
         std::sort(times.begin(), times.end());
         for (const auto &it : times)
             fout << it << '\n';
-        fout << std::endl;
+        fout << '\n';
         fout.close();
     }
 
-    // log average time if file_name is not empty
-    void printStatistics(string file_name = "")
+    // job completion time
+    //  finish time minus arrival time
+    double completionTime(const string &job)
     {
-        double avg = 0, mx = 0;
-        for (const auto &it : finish_time)
+        double ret = finish_time[job];
+        auto iter = workload->arrival.find(job);
+        if (iter != workload->arrival.end())
+            ret -= iter->second;
+        return ret;
+    }
+
+    // a slot of DC is busy in [start,end)
+    void addBusy(const string &DC, double start, double end)
+    {
+        busy[DC] += end - start;
+        last_time = std::max(last_time, end);
+        // split into windows
+        while (start < end)
         {
-            avg += it.second;
-            mx = std::max(mx, it.second);
+            int k = start / util_window;
+            double t = std::min(end, (k + 1) * util_window);
+            if (busy_series.size() <= k)
+                busy_series.resize(k + 1);
+            busy_series[k] += t - start;
+            start = t;
         }
-        avg /= finish_time.size();
-        double var = 0;
-        for (const auto &it : finish_time)
-            var += (it.second - avg) * (it.second - avg);
+    }
+
+    int totalSlots()
+    {
+        int ret = 0;
+        for (const auto &slot : slots)
+            ret += slot.second.first;
+        return ret;
+    }
+
+    // busy slot seconds over all slot seconds until last_time
+    double utilization()
+    {
+        double sum = 0;
+        for (const auto &it : busy)
+            sum += it.second;
+        double total = totalSlots() * last_time;
+        return total > 0 ? sum / total : 0;
+    }
+
+    // print statistics and append them to log
+    //  if file_name is not empty
+    // e.g. "12.5,4.2,2.1,p50=3.9,p90=8,...,busy_DC1=0.6,...,util_series=0.8;0.5"
+    //  first 3 columns are max, average and standard deviation,
+    //  then key=value columns
+    void printStatistics(string file_name = "")
+    {
+        double avg = stats.mean, mx = stats.mx;
+        const auto &jct = stats.jct;
         std::cout << "Average: " << avg << '\n'
                   << "Standard Deviation: "
-                  << std::sqrt(var / finish_time.size())
+                  << stats.stddev() << '\n'
+                  << "P50: " << jct.quantile(0.5) << ' '
+                  << "P90: " << jct.quantile(0.9) << ' '
+                  << "P99: " << jct.quantile(0.99) << ' '
+                  << "P99.9: " << jct.quantile(0.999) << '\n'
+                  << "Slowdown: " << stats.slowdownMean() << ' '
+                  << "P99: " << stats.slowdown.quantile(0.99) << '\n'
+                  << "Utilization: " << utilization() << '\n'
+                  << "Scheduler Time: " << stats.sched_time << ' '
+                  << "Rounds: " << stats.rounds
                   << std::endl;
         if (!file_name.empty())
         {
@@ -205,7 +702,41 @@ struct Graph
                 printWarning("Can't Open Log File");
             fout << mx << ','
                  << avg << ','
-                 << std::sqrt(var / finish_time.size()) << std::endl;
+                 << stats.stddev() << ','
+                 << "p50=" << jct.quantile(0.5) << ','
+                 << "p90=" << jct.quantile(0.9) << ','
+                 << "p99=" << jct.quantile(0.99) << ','
+                 << "p999=" << jct.quantile(0.999) << ','
+                 << "slowdown=" << stats.slowdownMean() << ','
+                 << "slowdown_p50=" << stats.slowdown.quantile(0.5) << ','
+                 << "slowdown_p99=" << stats.slowdown.quantile(0.99) << ','
+                 << "utilization=" << utilization() << ','
+                 << "sched_time=" << stats.sched_time << ','
+                 << "rounds=" << stats.rounds;
+            // sorted for stable columns
+            map<string, double> busy_sorted(busy.begin(), busy.end());
+            for (const auto &slot : slots)
+                busy_sorted.insert(make_pair(slot.first, 0.0));
+            for (const auto &it : busy_sorted)
+            {
+                int cap = slots[it.first].first;
+                double total = cap * last_time;
+                fout << ",busy_" << it.first << '='
+                     << (total > 0 ? it.second / total : 0);
+            }
+            fout << ",util_series=";
+            int total = totalSlots();
+            for (int k = 0; k < busy_series.size(); ++k)
+            {
+                // last window may be partial
+                double len = std::min(util_window,
+                                      last_time - k * util_window);
+                fout << (k ? ";" : "")
+                     << (total > 0 && len > 0
+                             ? busy_series[k] / (total * len)
+                             : 0);
+            }
+            fout << std::endl;
             fout.close();
         }
     }
@@ -219,7 +750,7 @@ struct Graph
         {
             fout << it.first << ','
                  << it.second.first << ','
-                 << it.second.second << std::endl;
+                 << it.second.second << '\n';
         }
         fout.close();
     }
@@ -248,61 +779,195 @@ struct UnionFindSet
     }
 };
 
-void init_data(shared_ptr<Graph> graph)
+// add one job of job_list.json to graph
+// e.g. {"name":"A","task":[{"name":"tA1","resource":[...],"time":1.5}]}
+void add_job(shared_ptr<Graph> graph, const json &this_job)
 {
-    // initailize constraint
-    json constraint;
-    std::ifstream constraint_file(DIR + "constraint.json");
-    if (!constraint_file.is_open())
-        printError("No constraint.json!");
-    constraint_file >> constraint;
-    for (const auto &iter : constraint["constraint"])
-    {
-        // <string,string>
-        // u->v
-        string prev = iter["start"];
-        string next = iter["end"];
-        graph->constraint.push_back(
-            make_pair(prev, next));
-        graph->prev_nodes[next].insert(prev);
-        graph->next_nodes[prev].insert(next);
-    }
-    constraint_file.close();
+    int num_of_task = this_job["task"].size();
+    string job_name = this_job["name"];
+    unordered_set<string> &job_task = graph->job_task[job_name];
+    Workload &work = *graph->workload;
 
-    // initialize run_time, require and job_task, which job
-    json job;
-    std::ifstream job_file(DIR + "job_list.json");
-    if (!job_file.is_open())
-        printError("No job_list.json");
-    job_file >> job;
-    int num_of_jobs = job["job"].size();
-    for (int i = 0; i < num_of_jobs; ++i)
+    for (int j = 0; j < num_of_task; ++j)
     {
-        const auto this_job = job["job"][i];
-        int num_of_task = this_job["task"].size();
-        string job_name = this_job["name"];
-        unordered_set<string> &job_task = graph->job_task[job_name];
+        const auto &this_task = this_job["task"][j];
+        string task_name = this_task["name"];
+
+        work.run_time[task_name] = this_task["time"]; // run time
+        job_task.insert(task_name);                   // job list
+        work.which_job[task_name] = job_name;         // which job
 
-        for (int j = 0; j < num_of_task; ++j)
+        int num_of_resource = this_task["resource"].size();
+        for (int k = 0; k < num_of_resource; ++k)
         {
-            const auto &this_task = this_job["task"][j];
-            string task_name = this_task["name"];
+            work.require[task_name].push_back(
+                make_pair(this_task["resource"][k]["name"],
+                          this_task["resource"][k]["size"]));
+        }
 
-            graph->run_time[task_name] = this_task["time"]; // run time
-            job_task.insert(task_name);                     // job list
-            graph->which_job[task_name] = job_name;         // which job
+        // e.g. "demand":{"cpu":2,"mem":4}
+        if (this_task.find("demand") != this_task.end())
+        {
+            vector<double> &need = work.demand[task_name];
+            for (const auto &it : this_task["demand"].items())
+            {
+                int k = work.dimId(it.key());
+                if (need.size() <= k)
+                    need.resize(k + 1);
+                need[k] = it.value();
+            }
+        }
+    }
+}
 
-            int num_of_resource = this_task["resource"].size();
-            for (int k = 0; k < num_of_resource; ++k)
+// prev->next
+void add_constraint(shared_ptr<Graph> graph,
+                    const string &prev, const string &next)
+{
+    graph->workload->constraint.push_back(
+        make_pair(prev, next));
+    graph->workload->prev_nodes[next].insert(prev);
+    graph->workload->next_nodes[prev].insert(next);
+}
+
+// task must fit in an empty DC, or it is never scheduled
+void check_demand(shared_ptr<Graph> graph, const string &task)
+{
+    for (const auto &slot : graph->slots)
+        if (slot.second.first > 0 && graph->workload->fits(task, slot.first))
+            return;
+    printError("No DC Fits Demand of " + task);
+}
+
+// 1/bandwidth, large if there is no link (-1)
+double link_weight(double bandwidth)
+{
+    const double INF = 1e6;
+    return bandwidth == -1 ? INF : 1 / bandwidth;
+}
+
+// edges from max flows between DCs, see pair_flow.hpp
+//  widest paths are lower bounds, so they must be right
+//  return pairs whose edge changed
+vector<pair<int, int>> pair_flows(Workload &work)
+{
+    WidestPaths &paths = work.paths;
+    int n = paths.names.size();
+    const double none = link_weight(-1);
+    // weights back to bandwidth, 0 if there is no link
+    auto width = [&](double w)
+    { return w >= none ? 0 : 1 / w; };
+    vector<vector<double>> bandwidth(n, vector<double>(n)),
+        widest(n, vector<double>(n));
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+        {
+            bandwidth[i][j] = width(paths.link[i][j]);
+            widest[i][j] = width(paths.dis[i][j]);
+        }
+    PairFlows flows;
+    vector<vector<double>> flow = flows.build(bandwidth, widest,
+                                              work.flow_threads);
+    work.flows_solved = flows.solved;
+
+    vector<pair<int, int>> changed;
+    for (int i = 0; i < n; ++i)
+    {
+        auto &row = work.edges[paths.names[i]];
+        for (int j = 0; j < n; ++j)
+        {
+            // diagonal is local bandwidth, as widest paths
+            double w = i == j ? paths.dis[i][j]
+                       : flow[i][j] > 0 ? 1 / flow[i][j]
+                                        : none;
+            auto iter = row.find(paths.names[j]);
+            if (iter == row.end() || iter->second != w)
             {
-                graph->require[task_name].push_back(
-                    make_pair(this_task["resource"][k]["name"],
-                              this_task["resource"][k]["size"]));
+                row[paths.names[j]] = w;
+                changed.emplace_back(i, j);
             }
         }
     }
-    job_file.close();
+    return changed;
+}
+
+// edges from links, O(DCs^3)
+//  and max flows if multipath
+void widest_paths(Workload &work)
+{
+    WidestPaths &paths = work.paths;
+    paths.build();
+    if (work.multipath)
+    {
+        pair_flows(work);
+        return;
+    }
+    int n = paths.names.size();
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            work.edges[paths.names[i]][paths.names[j]] = paths.dis[i][j];
+}
+
+// transfers use max flows between DCs instead of widest paths
+//  threads computing them, 0 for all cores
+// note: call it before forks and schedulers read edges
+void use_multipath(shared_ptr<Graph> graph, bool multipath = true,
+                   int threads = 0)
+{
+    Workload &work = *graph->workload;
+    work.multipath = multipath;
+    work.flow_threads = threads;
+    widest_paths(work);
+}
 
+// link u->v changes to bandwidth, -1 if it is down
+//  only edges whose widest path changed are updated
+//  and returned, e.g. {{"DC1","DC3"}}
+//  if multipath, all max flows are computed again
+// note: forks share the workload, never call it while they run
+vector<pair<string, string>> set_bandwidth(shared_ptr<Graph> graph,
+                                           const string &u,
+                                           const string &v,
+                                           double bandwidth)
+{
+    Workload &work = *graph->workload;
+    WidestPaths &paths = work.paths;
+    if (paths.id.find(u) == paths.id.end() ||
+        paths.id.find(v) == paths.id.end())
+        printError("No Such Link: " + u + " " + v);
+    work.bandwidth[u][v] = bandwidth;
+    vector<pair<string, string>> ret;
+    auto changed = paths.setLink(paths.id[u], paths.id[v],
+                                 link_weight(bandwidth));
+    // any max flow may use the link, all pairs again
+    if (work.multipath)
+    {
+        for (const auto &it : pair_flows(work))
+            ret.emplace_back(paths.names[it.first],
+                             paths.names[it.second]);
+        return ret;
+    }
+    for (const auto &it : changed)
+    {
+        const string &from = paths.names[it.first];
+        const string &to = paths.names[it.second];
+        work.edges[from][to] = paths.dis[it.first][it.second];
+        ret.emplace_back(from, to);
+    }
+    return ret;
+}
+
+// bandwidth of link u->v, -1 if it is down
+double get_bandwidth(shared_ptr<Graph> graph,
+                     const string &u, const string &v)
+{
+    return graph->workload->bandwidth.at(u).at(v);
+}
+
+// initialize resource_loc, edges and slots
+//  from DC.json and link.json
+void init_topology(shared_ptr<Graph> graph)
+{
     // initialize graph->resources
     json DC;
     std::ifstream DC_file(DIR + "DC.json");
@@ -315,7 +980,7 @@ void init_data(shared_ptr<Graph> graph)
         const auto &this_DC = DC["DC"][i];
         int num_of_resource = this_DC["data"].size();
         for (int j = 0; j < num_of_resource; ++j)
-            graph->resource_loc[this_DC["data"][j]] = this_DC["name"];
+            graph->workload->resource_loc[this_DC["data"][j]] = this_DC["name"];
     }
     DC_file.close();
 
@@ -325,7 +990,6 @@ void init_data(shared_ptr<Graph> graph)
     if (!link_file.is_open())
         printError("No link.json");
     link_file >> link;
-    const double INF = 1e6;
     for (int i = 0; i < num_of_dc; ++i)
     {
         for (int j = 0; j < num_of_dc; ++j)
@@ -333,42 +997,76 @@ void init_data(shared_ptr<Graph> graph)
             int bandwidth = link["link"][i]["bandwidth"][j];
             string u = link["link"][i]["start"];
             string v = link["link"][j]["start"];
-            graph->edges[u][v] = bandwidth == -1
-                                     ? INF
-                                     : 1 / double(bandwidth);
+            WidestPaths &paths = graph->workload->paths;
+            int from = paths.add(u, link_weight(-1));
+            int to = paths.add(v, link_weight(-1));
+            paths.link[from][to] = link_weight(bandwidth);
+            graph->workload->bandwidth[u][v] = bandwidth;
         }
     }
     link_file.close();
+    widest_paths(*graph->workload);
 
-    // Floyd
-    for (int k = 0; k < num_of_dc; ++k)
+    // initialize slots
+    for (int i = 0; i < num_of_dc; ++i)
     {
-        auto dc_k = DC["DC"][k]["name"];
+        const auto &this_DC = DC["DC"][i];
+        graph->slots[this_DC["name"]].first = this_DC["size"];
+    }
 
-        for (int i = 0; i < num_of_dc; ++i)
+    // initialize capacity
+    // e.g. "capacity":{"cpu":16,"mem":64}
+    //  dimensions not given are unlimited
+    Workload &work = *graph->workload;
+    for (int i = 0; i < num_of_dc; ++i)
+    {
+        const auto &this_DC = DC["DC"][i];
+        if (this_DC.find("capacity") == this_DC.end())
+            continue;
+        vector<double> &cap = work.capacity[this_DC["name"]];
+        for (const auto &it : this_DC["capacity"].items())
         {
-            auto dc_i = DC["DC"][i]["name"];
-            double d_ik = graph->edges[dc_i][dc_k];
-
-            for (int j = 0; j < num_of_dc; ++j)
-            {
-                auto dc_j = DC["DC"][j]["name"];
-                double d_kj = graph->edges[dc_k][dc_j];
-                double &d_ij = graph->edges[dc_i][dc_j];
-
-                // #### modify this to change bandwidth
-                // d_ij = std::min(d_ij, d_ik + d_kj);
-                d_ij = std::min(d_ij, std::max(d_ik, d_kj));
-            }
+            int k = work.dimId(it.key());
+            if (cap.size() <= k)
+                cap.resize(k + 1, std::numeric_limits<double>::max());
+            cap[k] = it.value();
         }
     }
+    for (auto &it : work.capacity)
+        it.second.resize(work.dims.size(),
+                         std::numeric_limits<double>::max());
+    for (const auto &it : work.demand)
+        check_demand(graph, it.first);
+}
 
-    // initialize slots
-    for (int i = 0; i < num_of_dc; ++i)
+void init_data(shared_ptr<Graph> graph)
+{
+    // initailize constraint
+    json constraint;
+    std::ifstream constraint_file(DIR + "constraint.json");
+    if (!constraint_file.is_open())
+        printError("No constraint.json!");
+    constraint_file >> constraint;
+    for (const auto &iter : constraint["constraint"])
     {
-        const auto &this_DC = DC["DC"][i];
-        graph->slots[this_DC["name"]].first = this_DC["size"];
+        // <string,string>
+        // u->v
+        add_constraint(graph, iter["start"], iter["end"]);
     }
+    constraint_file.close();
+
+    // initialize run_time, require and job_task, which job
+    json job;
+    std::ifstream job_file(DIR + "job_list.json");
+    if (!job_file.is_open())
+        printError("No job_list.json");
+    job_file >> job;
+    int num_of_jobs = job["job"].size();
+    for (int i = 0; i < num_of_jobs; ++i)
+        add_job(graph, job["job"][i]);
+    job_file.close();
+
+    init_topology(graph);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef __HISTOGRAM_HPP__
+#define __HISTOGRAM_HPP__
+
+#include <cmath>
+#include <vector>
+
+// streaming histogram with log-sized buckets (like HDR histogram)
+//  bucket i holds values in [lo*(1+precision)^i, lo*(1+precision)^(i+1))
+//  so quantiles have relative error of precision
+//  and memory only grows with log(max/lo)
+// e.g. with lo=1e-3 and precision=0.01,
+//  values up to 1e9 take about 2800 buckets
+class LogHistogram
+{
+private:
+    double lo, precision, log_base;
+    std::vector<long long> buckets;
+    long long cnt;
+    double mn, mx;
+
+    int bucket(double x) const
+    {
+        if (x <= lo)
+            return 0;
+        return (int)(std::log(x / lo) / log_base) + 1;
+    }
+
+public:
+    LogHistogram(double lo = 1e-3, double precision = 0.01)
+        : lo(lo), precision(precision),
+          log_base(std::log1p(precision)),
+          cnt(0), mn(0), mx(0) {}
+
+    void add(double x)
+    {
+        int i = bucket(x);
+        if (i >= buckets.size())
+            buckets.resize(i + 1);
+        buckets[i]++;
+        mn = cnt == 0 ? x : std::min(mn, x);
+        mx = cnt == 0 ? x : std::max(mx, x);
+        cnt++;
+    }
+
+    long long count() const
+    {
+        return cnt;
+    }
+
+    // q-th quantile by nearest rank, q in [0,1]
+    //  middle of the bucket, within [min,max] seen
+    double quantile(double q) const
+    {
+        if (cnt == 0)
+            return 0;
+        long long rank = std::max(1LL, (long long)std::ceil(q * cnt));
+        long long sum = 0;
+        for (int i = 0; i < buckets.size(); ++i)
+        {
+            sum += buckets[i];
+            if (sum >= rank)
+            {
+                double x = i == 0 ? lo
+                                  : lo * std::exp((i - 0.5) * log_base);
+                return std::min(mx, std::max(mn, x));
+            }
+        }
+        return mx;
+    }
+};
+
+#endif
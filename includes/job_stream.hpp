@@ -0,0 +1,182 @@
+#ifndef __JOB_STREAM_HPP__
+#define __JOB_STREAM_HPP__
+
+#include "common.hpp"
+
+// a job submitted at time arrival
+struct JobArrival
+{
+    double arrival;
+
+    // same format as one job in job_list.json
+    // e.g. {"name":"A","task":[{"name":"tA1",...}]}
+    json job;
+
+    // constraints among tasks of this job
+    // e.g. {{"tA1","tA2"}}
+    //  tA2 need the result of tA1
+    vector<pair<string, string>> constraint;
+};
+
+// jobs arriving over time, in order of arrival
+//
+// read from
+//  job_stream.jsonl if it exists, one job per line
+//      e.g. {"name":"A","arrival":3.5,"task":[...],
+//            "constraint":[{"start":"tA1","end":"tA2"}]}
+//      only one line is kept in memory,
+//      so lines should be sorted by arrival
+//  job_list.json and constraint.json otherwise
+//      loaded at once, only for small traces
+//
+// job without "arrival" is drawn from a Poisson process
+//  with rate jobs per second (arrives at 0 if rate is 0)
+class JobStream
+{
+private:
+    // job_stream.jsonl
+    std::ifstream fin;
+
+    // jobs read but not arrived
+    std::deque<JobArrival> pending;
+
+    // arrival of the last job read
+    double last_arrival;
+
+    // draws of Poisson process
+    Rng gen;
+
+private:
+    // arrival time of job
+    //  from "arrival" or Poisson process
+    double drawArrival(const json &job)
+    {
+        double ret = 0;
+        if (job.find("arrival") != job.end())
+            ret = job["arrival"];
+        else if (rate > 0)
+        {
+            std::exponential_distribution<double> dis(rate);
+            ret = last_arrival + dis(gen);
+        }
+        return ret;
+    }
+
+    // read next line of job_stream.jsonl into pending
+    bool readLine()
+    {
+        string line;
+        while (std::getline(fin, line))
+        {
+            if (line.empty())
+                continue;
+            JobArrival item;
+            item.job = json::parse(line);
+            item.arrival = drawArrival(item.job);
+            if (item.arrival < last_arrival)
+            {
+                printWarning("job_stream.jsonl is not sorted by arrival");
+                item.arrival = last_arrival;
+            }
+            last_arrival = item.arrival;
+            for (const auto &it : item.job["constraint"])
+                item.constraint.push_back(
+                    make_pair(it["start"], it["end"]));
+            item.job.erase("constraint");
+            pending.push_back(std::move(item));
+            return true;
+        }
+        return false;
+    }
+
+    // read all jobs in job_list.json
+    //  and sort them by arrival
+    void readAll()
+    {
+        json job;
+        std::ifstream job_file(DIR + "job_list.json");
+        if (!job_file.is_open())
+            printError("No job_list.json");
+        job_file >> job;
+        job_file.close();
+
+        // e.g. {"tA1",0}
+        //  tA1 belongs to 0th job
+        unordered_map<string, int> job_id;
+        int num_of_jobs = job["job"].size();
+        for (int i = 0; i < num_of_jobs; ++i)
+        {
+            JobArrival item;
+            item.job = std::move(job["job"][i]);
+            item.arrival = drawArrival(item.job);
+            last_arrival = std::max(last_arrival, item.arrival);
+            for (const auto &task : item.job["task"])
+                job_id[task["name"]] = i;
+            pending.push_back(std::move(item));
+        }
+
+        json constraint;
+        std::ifstream constraint_file(DIR + "constraint.json");
+        if (!constraint_file.is_open())
+            printError("No constraint.json!");
+        constraint_file >> constraint;
+        for (const auto &iter : constraint["constraint"])
+        {
+            string prev = iter["start"];
+            string next = iter["end"];
+            if (job_id.find(prev) == job_id.end())
+                printError("No Such Task: " + prev);
+            pending[job_id[prev]].constraint.push_back(
+                make_pair(prev, next));
+        }
+        constraint_file.close();
+
+        std::stable_sort(pending.begin(), pending.end(),
+                         [](const JobArrival &a, const JobArrival &b)
+                         { return a.arrival < b.arrival; });
+    }
+
+public:
+    // jobs per second of Poisson process
+    double rate;
+
+    JobStream() : last_arrival(0), rate(0) {}
+
+    void open(double rate, uint64_t seed, uint64_t replication = 0)
+    {
+        this->rate = rate;
+        gen.seed(seed, "arrival", replication);
+        fin.open(DIR + "job_stream.jsonl");
+        if (fin.is_open())
+            readLine();
+        else
+            readAll();
+    }
+
+    // no more jobs
+    bool empty()
+    {
+        return pending.empty();
+    }
+
+    // arrival time of next job
+    double nextTime()
+    {
+        if (pending.empty())
+            printError("JobStream is Empty!");
+        return pending.front().arrival;
+    }
+
+    JobArrival pop()
+    {
+        if (pending.empty())
+            printError("JobStream is Empty!");
+        JobArrival ret = std::move(pending.front());
+        pending.pop_front();
+        if (fin.is_open() && pending.empty())
+            readLine();
+        return ret;
+    }
+};
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef __MCTS_HPP__
+#define __MCTS_HPP__
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "common.hpp"
+
+// Monte Carlo tree search over scheduling rounds
+//  a node is the state after a path of decisions,
+//  every node has `actions` children, one per candidate assignment
+// evaluate(path) replays path from the root and returns its cost
+//  (smaller is better), so threads share nothing but the tree
+// parallel workers use virtual loss to spread over the tree
+class MCTS
+{
+private:
+    struct Node
+    {
+        int visits;
+        // evaluations through this node not finished yet
+        //  each counts as virtual_loss visits with the worst cost
+        int running;
+        // sum of costs of evaluations through this node
+        double cost;
+        // index of first child, children are contiguous
+        //  -1 if not expanded
+        int child;
+
+        Node() : visits(0), running(0), cost(0), child(-1) {}
+    };
+    // note: only touched with lock held
+    vector<Node> nodes;
+    std::mutex lock;
+
+    // range of costs seen, to normalize values into [0,1]
+    double lo, hi;
+    int iterations;
+
+private:
+    // visits including virtual loss
+    int count(const Node &node)
+    {
+        return node.visits + node.running * virtual_loss;
+    }
+
+    // value of node in [0,1], larger is better
+    double value(const Node &node)
+    {
+        if (hi - lo < 1e-12)
+            return 0.5;
+        double mean = (node.cost + node.running * virtual_loss * hi) /
+                      count(node);
+        return (hi - mean) / (hi - lo);
+    }
+
+    // UCT child of node x
+    int selectChild(int x)
+    {
+        const Node &parent = nodes[x];
+        int best = -1;
+        double best_score = -1;
+        for (int i = 0; i < actions; ++i)
+        {
+            const Node &node = nodes[parent.child + i];
+            if (count(node) == 0)
+                return i;
+            double score = value(node) +
+                           exploration *
+                               std::sqrt(std::log(count(parent)) / count(node));
+            if (score > best_score)
+                best_score = score, best = i;
+        }
+        return best;
+    }
+
+    // walk down from root with virtual loss
+    //  expand the leaf if it has been visited
+    vector<int> select()
+    {
+        vector<int> path;
+        int x = 0;
+        while (true)
+        {
+            nodes[x].running++;
+            if (path.size() >= max_depth)
+                break;
+            if (nodes[x].child == -1)
+            {
+                if (x != 0 && nodes[x].visits == 0)
+                    break; // first visit of this leaf
+                nodes[x].child = nodes.size();
+                nodes.resize(nodes.size() + actions);
+            }
+            int a = selectChild(x);
+            path.push_back(a);
+            x = nodes[x].child + a;
+        }
+        return path;
+    }
+
+    // remove virtual loss and add cost along path
+    void backup(const vector<int> &path, double cost)
+    {
+        int x = 0;
+        for (int i = 0; i <= path.size(); ++i)
+        {
+            nodes[x].running--;
+            nodes[x].visits++;
+            nodes[x].cost += cost;
+            if (i < path.size())
+                x = nodes[x].child + path[i];
+        }
+    }
+
+    void worker(const std::function<double(const vector<int> &)> &evaluate,
+                std::chrono::steady_clock::time_point deadline)
+    {
+        while (true)
+        {
+            vector<int> path;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                // every root action is tried at least once
+                if (iterations >= actions &&
+                    std::chrono::steady_clock::now() > deadline)
+                    return;
+                iterations++;
+                path = select();
+            }
+            double cost = evaluate(path);
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                backup(path, cost);
+                lo = std::min(lo, cost);
+                hi = std::max(hi, cost);
+            }
+        }
+    }
+
+public:
+    // children of each node
+    int actions = 4;
+    // decisions looked ahead at most
+    int max_depth = 3;
+    // UCT exploration constant
+    double exploration = 1.4;
+    // visits added to nodes on a running path
+    int virtual_loss = 1;
+
+    // search for budget seconds with threads workers
+    //  return the root action visited most
+    int search(const std::function<double(const vector<int> &)> &evaluate,
+               double budget, int threads)
+    {
+        nodes.assign(1, Node());
+        lo = std::numeric_limits<double>::max();
+        hi = 0;
+        iterations = 0;
+
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(budget));
+        vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i)
+            workers.emplace_back(&MCTS::worker, this,
+                                 std::cref(evaluate), deadline);
+        for (auto &it : workers)
+            it.join();
+
+        int best = 0;
+        for (int i = 1; i < actions; ++i)
+        {
+            const Node &a = nodes[nodes[0].child + i];
+            const Node &b = nodes[nodes[0].child + best];
+            if (a.visits > b.visits ||
+                (a.visits == b.visits && a.visits > 0 &&
+                 a.cost / a.visits < b.cost / b.visits))
+                best = i;
+        }
+        return best;
+    }
+
+    // number of evaluations in last search
+    int getIterations()
+    {
+        return iterations;
+    }
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "common.hpp"
+#include "augmenting_path.hpp"
 
 // NOTE: min{cost} max flow
 
@@ -74,9 +75,43 @@ private:
     vector<Edge> edges;
     // current edge optimization
     vector<int> cur_head;
-    vector<int> prev;
+    // shortest augmenting paths of min cost flow
+    AugmentingPath<Edge> path;
     // <----- Dinic end
 
+    // -----> push-relabel begin
+    // e.g. height[2]==3
+    //  node 2 is 3 edges away from sink at least
+    //  node with height >= nodes can not reach sink
+    vector<int> height;
+    vector<int> excess;
+    // current edge of each node
+    vector<int> cur_edge;
+    // active nodes of each height, may be stale
+    vector<vector<int>> active;
+    // number of nodes of each height, for gap heuristic
+    vector<int> height_cnt;
+    int max_active;
+    // relabels since last global relabel
+    int relabel_cnt;
+    // <----- push-relabel end
+
+    // -----> matching begin
+    // tasks (0-based, node DC_num+t) matched to DCs in flat arrays
+    //  task t's edges are [adj_begin[t], adj_begin[t+1])
+    vector<int> adj_begin, adj_DC, adj_edge;
+    vector<double> adj_val;
+    // e.g. match_adj[3]==7
+    //  task 3 is matched by its edge 7, -1 if free
+    vector<int> match_adj;
+    // tasks matched to each DC, pos is index of task in it
+    vector<vector<int>> DC_tasks;
+    vector<int> pos;
+    // free slots of each DC, source edge and sink edge ids
+    vector<int> DC_cap, source_edge, sink_edge;
+    vector<int> task_dis, DC_dis;
+    // <----- matching end
+
     // task group scheduling
     // e.g. {{"tA1","tA2"}}
     vector<vector<string>> task_group;
@@ -115,7 +150,7 @@ private:
     {
         // initialize head with -1
         head = vector<int>(2 + DC_num + task_num, -1);
-        prev = vector<int>(2 + DC_num + task_num);
+        path.init(2 + DC_num + task_num, source, sink);
 
         // link source to DC
         for (const auto &it : cap_info)
@@ -217,17 +252,407 @@ private:
         return ret;
     }
 
+    // -----> push-relabel begin
+
+    bool allowed(int i, double val_bound) const
+    {
+        return edges[i].cap > 0 && edges[i].val <= val_bound;
+    }
+
+    void activate(int x)
+    {
+        int n = head.size();
+        if (x == source || x == sink || height[x] >= n)
+            return;
+        active[height[x]].push_back(x);
+        max_active = std::max(max_active, height[x]);
+    }
+
+    // exact heights by BFS from sink in residual network
+    void globalRelabel(double val_bound)
+    {
+        int n = head.size();
+        height.assign(n, n);
+        height[sink] = 0;
+        vector<int> Q = {sink};
+        for (int k = 0; k < Q.size(); ++k)
+        {
+            int x = Q[k];
+            for (int i = head[x]; ~i; i = edges[i].next)
+            {
+                int to = edges[i].v;
+                // i^1 is to -> x
+                if (height[to] == n && to != source &&
+                    allowed(i ^ 1, val_bound))
+                {
+                    height[to] = height[x] + 1;
+                    Q.push_back(to);
+                }
+            }
+        }
+
+        height_cnt.assign(n + 1, 0);
+        for (auto &it : active)
+            it.clear();
+        max_active = 0;
+        for (int x = 0; x < n; ++x)
+        {
+            height_cnt[height[x]]++;
+            cur_edge[x] = head[x];
+            if (excess[x] > 0)
+                activate(x);
+        }
+        relabel_cnt = 0;
+    }
+
+    void push(int x, int i)
+    {
+        int to = edges[i].v;
+        int flow = std::min(excess[x], edges[i].cap);
+        edges[i].cap -= flow;
+        edges[i ^ 1].cap += flow;
+        excess[x] -= flow;
+        excess[to] += flow;
+        // to was not active
+        if (excess[to] == flow)
+            activate(to);
+    }
+
+    void relabel(int x, double val_bound)
+    {
+        int n = head.size();
+        int old = height[x], h = n;
+        for (int i = head[x]; ~i; i = edges[i].next)
+            if (allowed(i, val_bound))
+                h = std::min(h, height[edges[i].v] + 1);
+        height_cnt[old]--;
+        if (height_cnt[old] == 0)
+        {
+            // gap: nodes above old can not reach sink any more
+            for (int y = 0; y < n; ++y)
+                if (height[y] > old && height[y] < n)
+                {
+                    height_cnt[height[y]]--;
+                    height[y] = n;
+                    height_cnt[n]++;
+                }
+            h = n;
+        }
+        height[x] = std::min(h, n);
+        height_cnt[height[x]]++;
+        cur_edge[x] = head[x];
+        relabel_cnt++;
+    }
+
+    void discharge(int x, double val_bound)
+    {
+        int n = head.size();
+        while (excess[x] > 0 && height[x] < n)
+        {
+            int i = cur_edge[x];
+            if (i == -1)
+            {
+                relabel(x, val_bound);
+                continue;
+            }
+            if (allowed(i, val_bound) &&
+                height[x] == height[edges[i].v] + 1)
+                push(x, i);
+            else
+                cur_edge[x] = edges[i].next;
+        }
+    }
+
+    // highest-label push-relabel
+    //  with gap and global relabel heuristics, no recursion
+    // note: only use edges with value < val_bound
+    int PushRelabel(double val_bound)
+    {
+        for (auto &edge : edges)
+            edge.cap = edge.ori_cap;
+
+        int n = head.size();
+        excess.assign(n, 0);
+        cur_edge.resize(n);
+        active.resize(n + 1);
+        for (int i = head[source]; ~i; i = edges[i].next)
+            if (allowed(i, val_bound))
+            {
+                int flow = edges[i].cap;
+                edges[i].cap = 0;
+                edges[i ^ 1].cap += flow;
+                excess[edges[i].v] += flow;
+            }
+        globalRelabel(val_bound);
+
+        // phase 1: max preflow
+        while (max_active >= 0)
+        {
+            if (active[max_active].empty())
+            {
+                max_active--;
+                continue;
+            }
+            int x = active[max_active].back();
+            active[max_active].pop_back();
+            if (height[x] != max_active || excess[x] == 0)
+                continue;
+            discharge(x, val_bound);
+            if (relabel_cnt >= n)
+                globalRelabel(val_bound);
+        }
+
+        // phase 2: return excess to source
+        //  flow only goes source -> DC -> task -> sink,
+        //  so return tasks' excess to DCs then DCs' to source
+        //  along reversed edges (odd ids)
+        for (int x = DC_num + task_num - 1; x >= 0; --x)
+            for (int i = head[x]; ~i && excess[x] > 0;
+                 i = edges[i].next)
+                if ((i & 1) && edges[i].cap > 0)
+                {
+                    int flow = std::min(excess[x], edges[i].cap);
+                    edges[i].cap -= flow;
+                    edges[i ^ 1].cap += flow;
+                    excess[x] -= flow;
+                    excess[edges[i].v] += flow;
+                }
+
+        return excess[sink];
+    }
+
+    // <----- push-relabel end
+
+    // -----> matching begin
+
+    void matchTask(int t, int k)
+    {
+        int DC = adj_DC[k];
+        match_adj[t] = k;
+        pos[t] = DC_tasks[DC].size();
+        DC_tasks[DC].push_back(t);
+    }
+
+    void unmatchTask(int t)
+    {
+        auto &list = DC_tasks[adj_DC[match_adj[t]]];
+        int last = list.back();
+        list[pos[t]] = last;
+        pos[last] = pos[t];
+        list.pop_back();
+        match_adj[t] = -1;
+    }
+
+    // flatten DC->task edges once, refresh values and capacities
+    //  as updateJob() and decCapacityDC() change them
+    void loadMatching()
+    {
+        if (adj_begin.empty())
+        {
+            vector<vector<int>> task_edges(task_num);
+            for (int i = 0; i < DC_num; ++i)
+                for (int j = head[i]; ~j; j = edges[j].next)
+                    if (edges[j].v != source)
+                        task_edges[edges[j].v - DC_num].push_back(j);
+            adj_begin.push_back(0);
+            for (const auto &list : task_edges)
+            {
+                for (int j : list)
+                {
+                    adj_edge.push_back(j);
+                    adj_DC.push_back(edges[j ^ 1].v);
+                }
+                adj_begin.push_back(adj_edge.size());
+            }
+            adj_val.resize(adj_edge.size());
+            match_adj.assign(task_num, -1);
+            pos.assign(task_num, 0);
+            DC_tasks.assign(DC_num, {});
+            source_edge.assign(DC_num, -1);
+            sink_edge.assign(task_num, -1);
+            for (int j = head[source]; ~j; j = edges[j].next)
+                source_edge[edges[j].v] = j;
+            for (int t = 0; t < task_num; ++t)
+                for (int j = head[DC_num + t]; ~j; j = edges[j].next)
+                    if (edges[j].v == sink)
+                        sink_edge[t] = j;
+        }
+        for (int k = 0; k < adj_edge.size(); ++k)
+            adj_val[k] = edges[adj_edge[k]].val;
+        DC_cap.assign(DC_num, 0);
+        for (int i = 0; i < DC_num; ++i)
+            if (~source_edge[i])
+                DC_cap[i] = edges[source_edge[i]].ori_cap;
+    }
+
+    // BFS from free tasks, layers alternate task -> DC -> its tasks
+    //  true if a DC with free slot is reached
+    bool matchBFS(double val_bound)
+    {
+        static const int INF = std::numeric_limits<int>::max();
+        task_dis.assign(task_num, INF);
+        DC_dis.assign(DC_num, INF);
+        vector<int> Q;
+        for (int t = 0; t < task_num; ++t)
+            if (match_adj[t] == -1)
+                task_dis[t] = 0, Q.push_back(t);
+
+        bool found = false;
+        for (int q = 0; q < Q.size(); ++q)
+        {
+            int t = Q[q];
+            for (int k = adj_begin[t]; k < adj_begin[t + 1]; ++k)
+            {
+                int DC = adj_DC[k];
+                if (adj_val[k] > val_bound || k == match_adj[t] ||
+                    DC_dis[DC] != INF)
+                    continue;
+                DC_dis[DC] = task_dis[t] + 1;
+                if (DC_tasks[DC].size() < DC_cap[DC])
+                    found = true;
+                else
+                    for (int w : DC_tasks[DC])
+                        if (task_dis[w] == INF)
+                            task_dis[w] = DC_dis[DC], Q.push_back(w);
+            }
+        }
+        return found;
+    }
+
+    // find an augmenting path from free task root along BFS layers
+    //  iterative, so deep paths do not overflow the stack
+    bool matchDFS(int root, double val_bound)
+    {
+        static const int INF = std::numeric_limits<int>::max();
+        struct Frame
+        {
+            int task, k;
+            // next task to try in DC of edge k, -1 if not in DC
+            int idx;
+        };
+        vector<Frame> stack = {{root, adj_begin[root], -1}};
+        while (!stack.empty())
+        {
+            Frame &f = stack.back();
+            int t = f.task;
+            if (f.idx != -1)
+            {
+                // try to move a task out of this DC
+                const auto &list = DC_tasks[adj_DC[f.k]];
+                if (f.idx < list.size())
+                {
+                    int w = list[f.idx++];
+                    if (task_dis[w] == DC_dis[adj_DC[f.k]])
+                        stack.push_back({w, adj_begin[w], -1});
+                    continue;
+                }
+                f.idx = -1, f.k++;
+                continue;
+            }
+            if (f.k == adj_begin[t + 1])
+            {
+                // dead end in this phase
+                task_dis[t] = INF;
+                stack.pop_back();
+                continue;
+            }
+            int DC = adj_DC[f.k];
+            if (adj_val[f.k] > val_bound || f.k == match_adj[t] ||
+                DC_dis[DC] != task_dis[t] + 1)
+            {
+                f.k++;
+                continue;
+            }
+            if (DC_tasks[DC].size() >= DC_cap[DC])
+            {
+                f.idx = 0;
+                continue;
+            }
+            // free slot, every task on stack moves to DC of its edge
+            for (int i = stack.size() - 1; i >= 0; --i)
+            {
+                int u = stack[i].task;
+                if (match_adj[u] != -1)
+                    unmatchTask(u);
+                matchTask(u, stack[i].k);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Hopcroft-Karp b-matching of tasks to DC slots
+    //  starts from matching of last call, without edges > val_bound
+    // note: only use edges with value < val_bound
+    int Matching(double val_bound)
+    {
+        int ret = 0;
+        for (int t = 0; t < task_num; ++t)
+            if (match_adj[t] != -1 && adj_val[match_adj[t]] > val_bound)
+                unmatchTask(t);
+        for (int i = 0; i < DC_num; ++i)
+            while (DC_tasks[i].size() > DC_cap[i])
+                unmatchTask(DC_tasks[i].back());
+        for (int t = 0; t < task_num; ++t)
+            ret += match_adj[t] != -1;
+
+        while (matchBFS(val_bound))
+            for (int t = 0; t < task_num; ++t)
+                if (task_dis[t] == 0 && matchDFS(t, val_bound))
+                    ret++;
+        return ret;
+    }
+
+    // write matching into residual capacities of edges
+    //  as if it were found by Dinic
+    void storeMatching()
+    {
+        for (auto &edge : edges)
+            edge.cap = edge.ori_cap;
+        for (int t = 0; t < task_num; ++t)
+        {
+            int k = match_adj[t];
+            if (k == -1)
+                continue;
+            int ids[] = {source_edge[adj_DC[k]], adj_edge[k], sink_edge[t]};
+            for (int i : ids)
+                edges[i].cap--, edges[i ^ 1].cap++;
+        }
+    }
+
+    // <----- matching end
+
+    int maxFlow(double val_bound)
+    {
+        switch (flow_type)
+        {
+        case PUSH_RELABEL:
+            return PushRelabel(val_bound);
+        case MATCHING:
+            return Matching(val_bound);
+        case DINIC:
+            break;
+        }
+        return Dinic(val_bound);
+    }
+
     // note: this is not common MCMF(min cost max flow)
     // this is actually min{cost[edge]} with max flow
     // here, we use binary search to find the answer
     double MCMF(int K) // K th iteration
     {
         double L = 0, R = max_val + eps * 10;
+        if (flow_type == MATCHING)
+            loadMatching();
 
         while (fabs(R - L) > eps / 10)
         {
             double mid = (L + R) / 2;
-            int flow = Dinic(mid);
+            // costs through a down link are ~1e6 per unit,
+            //  where adjacent doubles are farther than eps / 10
+            if (mid <= L || mid >= R)
+                break;
+            int flow = maxFlow(mid);
 
             if (flow > task_num - K)
                 printError("Compute Max Flow " + std::to_string(flow) +
@@ -240,11 +665,13 @@ private:
                 L = mid;
         }
 
-        // invoke Dinic again
+        // invoke max flow again
         // note: to avoid floating point precision
         //  cause some subtle bugs
-        if (Dinic(R) < task_num - K)
+        if (maxFlow(R) < task_num - K)
             printError("No Enough Slots");
+        if (flow_type == MATCHING)
+            storeMatching();
 
         return R;
     }
@@ -376,65 +803,10 @@ private:
                 edge.val = edge.ori_val;
     }
 
-    // use SPFA to find augmenting path
-    int SPFA()
-    {
-        // cost
-        vector<double> dis(2 + DC_num + task_num,
-                           std::numeric_limits<double>::max());
-        // capacity
-        vector<int> cap(2 + DC_num + task_num, 0);
-        vector<bool> inq(2 + DC_num + task_num, false);
-        std::queue<int> Q;
-
-        dis[source] = 0;
-        cap[source] = std::numeric_limits<int>::max();
-        inq[source] = true;
-        Q.push(source);
-
-        while (!Q.empty())
-        {
-            int x = Q.front();
-            Q.pop(), inq[x] = false;
-            for (int i = head[x]; ~i; i = edges[i].next)
-            {
-                int to = edges[i].v;
-                double cost = edges[i].val;
-                if (edges[i].cap > 0 &&
-                    dis[x] + cost < dis[to])
-                {
-                    dis[to] = dis[x] + cost;
-                    prev[to] = i; // edge id
-                    cap[to] = std::min(cap[x], edges[i].cap);
-                    if (!inq[to])
-                        Q.push(to), inq[to] = true;
-                }
-            }
-        }
-        return cap[sink];
-    }
-
-    // update path
-    void updateEdge(int flow)
-    {
-        for (int i = sink; i != source;
-             i = edges[prev[i] ^ 1].v)
-        {
-            edges[prev[i]].cap -= flow;
-            edges[prev[i] ^ 1].cap += flow;
-        }
-    }
-
     // min cost sum max flow
     int MCMF()
     {
-        int ret = 0, new_flow;
-        while (new_flow = SPFA())
-        {
-            ret += new_flow;
-            updateEdge(new_flow);
-        }
-        return ret;
+        return path.minCostFlow(head, edges, &Edge::val);
     }
 
     // main function schedule all tasks
@@ -493,7 +865,17 @@ public:
         SIMPLE
     } sched_type;
 
-    NetworkNeck() : max_val(0) {}
+    // max flow of feasibility checks in MCMF(K)
+    //  DINIC is recursive, PUSH_RELABEL is not
+    //  MATCHING is specialized for this network
+    enum FlowType
+    {
+        DINIC,
+        PUSH_RELABEL,
+        MATCHING
+    } flow_type;
+
+    NetworkNeck() : max_val(0), flow_type(MATCHING) {}
 
     // e.g. {{"tA1","tA2"},{"tB2"}} in task_group
     //  tA1 and tA2 belong to same job
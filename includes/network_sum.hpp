@@ -1,4 +1,5 @@
 #include "common.hpp"
+#include "augmenting_path.hpp"
 
 // NOTE: min cost sum max flow
 
@@ -67,7 +68,8 @@ private:
     // array of all edges
     // note: i^1 is residual edge
     vector<Edge> edges;
-    vector<int> prev;
+    // shortest augmenting paths of min cost flow
+    AugmentingPath<Edge> path;
     // <----- MCMF end
 
     // e.g. {{4,{"DC1","tA1"}}}
@@ -100,7 +102,7 @@ private:
     {
         // initialize head with -1
         head = vector<int>(2 + DC_num + task_num, -1);
-        prev = vector<int>(2 + DC_num + task_num);
+        path.init(2 + DC_num + task_num, source, sink);
 
         // link source to DC
         for (const auto &it : cap_info)
@@ -128,65 +130,10 @@ private:
         }
     }
 
-    // use SPFA to find augmenting path
-    int SPFA()
-    {
-        // cost
-        vector<double> dis(2 + DC_num + task_num,
-                           std::numeric_limits<double>::max());
-        // capacity
-        vector<int> cap(2 + DC_num + task_num, 0);
-        vector<bool> inq(2 + DC_num + task_num, false);
-        std::queue<int> Q;
-
-        dis[source] = 0;
-        cap[source] = std::numeric_limits<int>::max();
-        inq[source] = true;
-        Q.push(source);
-
-        while (!Q.empty())
-        {
-            int x = Q.front();
-            Q.pop(), inq[x] = false;
-            for (int i = head[x]; ~i; i = edges[i].next)
-            {
-                int to = edges[i].v;
-                double cost = edges[i].cost;
-                if (edges[i].cap > 0 &&
-                    dis[x] + cost < dis[to])
-                {
-                    dis[to] = dis[x] + cost;
-                    prev[to] = i; // edge id
-                    cap[to] = std::min(cap[x], edges[i].cap);
-                    if (!inq[to])
-                        Q.push(to), inq[to] = true;
-                }
-            }
-        }
-        return cap[sink];
-    }
-
-    // update path
-    void updateEdge(int flow)
-    {
-        for (int i = sink; i != source;
-             i = edges[prev[i] ^ 1].v)
-        {
-            edges[prev[i]].cap -= flow;
-            edges[prev[i] ^ 1].cap += flow;
-        }
-    }
-
     // min cost sum max flow
     int MCMF()
     {
-        int ret = 0, new_flow;
-        while (new_flow = SPFA())
-        {
-            ret += new_flow;
-            updateEdge(new_flow);
-        }
-        return ret;
+        return path.minCostFlow(head, edges, &Edge::cost);
     }
 
     // read (remaining) scheduled tasks from network
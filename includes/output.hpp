@@ -0,0 +1,248 @@
+#ifndef __OUTPUT_HPP__
+#define __OUTPUT_HPP__
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// buffered writer of finished tasks and jobs
+//  appended as they complete, never flushed per line
+//
+// CSV
+//  tasks: "task,DC,start,transfer,run_time" per line
+//      start is when the task starts running,
+//      after transfer time of its inputs
+//  jobs: "job finish_time" per line, same as printFinishTime()
+//
+// BINARY (columnar, little endian)
+//  file: "SPAN" or "JOBS", uint32 version, then blocks
+//  block: uint32 rows
+//      uint32 new_dc, new_dc * (uint16 len, bytes)  [tasks only]
+//          appended to DC dictionary, id by order
+//      rows * (uint16 len, bytes)      name column
+//      rows * uint32                   DC id column  [tasks only]
+//      rows * double                   start column  [tasks only]
+//      rows * double                   transfer column  [tasks only]
+//      rows * double                   run_time / finish_time column
+// see scripts/read_columnar.py
+class OutputSink
+{
+public:
+    enum Format
+    {
+        CSV,
+        BINARY
+    } format;
+
+private:
+    static const size_t BUFFER_SIZE = 1 << 20;
+    static const size_t BLOCK_ROWS = 1 << 16;
+    static const uint32_t VERSION = 1;
+
+    // a file with its write buffer
+    struct Writer
+    {
+        FILE *file;
+        std::string buf;
+
+        Writer() : file(nullptr) {}
+
+        bool open(const std::string &file_name)
+        {
+            file = fopen(file_name.c_str(), "wb");
+            buf.reserve(BUFFER_SIZE);
+            return file != nullptr;
+        }
+
+        void flush()
+        {
+            if (file && !buf.empty())
+                fwrite(buf.data(), 1, buf.size(), file);
+            buf.clear();
+        }
+
+        void close()
+        {
+            flush();
+            if (file)
+                fclose(file);
+            file = nullptr;
+        }
+
+        void write(const char *p, size_t n)
+        {
+            if (buf.size() + n > BUFFER_SIZE)
+                flush();
+            buf.append(p, n);
+        }
+
+        template <typename T>
+        void writeRaw(T x)
+        {
+            write(reinterpret_cast<const char *>(&x), sizeof(T));
+        }
+
+        void writeString(const std::string &s)
+        {
+            writeRaw<uint16_t>(s.size());
+            write(s.data(), s.size());
+        }
+
+        // same as default precision of ostream
+        void writeDouble(double x)
+        {
+            char tmp[32];
+            int n = snprintf(tmp, sizeof(tmp), "%g", x);
+            write(tmp, n);
+        }
+    };
+    Writer task_out, job_out;
+
+    // -----> BINARY columns begin
+    std::vector<std::string> task_name, job_name;
+    std::vector<uint32_t> task_DC;
+    std::vector<double> task_start, task_transfer, task_run;
+    std::vector<double> job_finish;
+    // {"DC1",0}
+    std::unordered_map<std::string, uint32_t> DC_id;
+    // DC first seen in this block
+    std::vector<std::string> new_DC;
+    // <----- BINARY columns end
+
+private:
+    void flushTaskBlock()
+    {
+        if (task_name.empty())
+            return;
+        Writer &w = task_out;
+        w.writeRaw<uint32_t>(task_name.size());
+        w.writeRaw<uint32_t>(new_DC.size());
+        for (const auto &DC : new_DC)
+            w.writeString(DC);
+        for (const auto &name : task_name)
+            w.writeString(name);
+        w.write(reinterpret_cast<const char *>(task_DC.data()),
+                task_DC.size() * sizeof(uint32_t));
+        w.write(reinterpret_cast<const char *>(task_start.data()),
+                task_start.size() * sizeof(double));
+        w.write(reinterpret_cast<const char *>(task_transfer.data()),
+                task_transfer.size() * sizeof(double));
+        w.write(reinterpret_cast<const char *>(task_run.data()),
+                task_run.size() * sizeof(double));
+        new_DC.clear();
+        task_name.clear(), task_DC.clear();
+        task_start.clear(), task_transfer.clear(), task_run.clear();
+    }
+
+    void flushJobBlock()
+    {
+        if (job_name.empty())
+            return;
+        Writer &w = job_out;
+        w.writeRaw<uint32_t>(job_name.size());
+        for (const auto &name : job_name)
+            w.writeString(name);
+        w.write(reinterpret_cast<const char *>(job_finish.data()),
+                job_finish.size() * sizeof(double));
+        job_name.clear(), job_finish.clear();
+    }
+
+public:
+    OutputSink() : format(CSV) {}
+
+    ~OutputSink()
+    {
+        close();
+    }
+
+    // job_file may be empty, then jobs are not written
+    // false if any file can't be opened
+    bool open(const std::string &task_file,
+              const std::string &job_file,
+              Format format = CSV)
+    {
+        this->format = format;
+        bool ret = task_out.open(task_file);
+        if (!job_file.empty())
+            ret &= job_out.open(job_file);
+        if (format == BINARY)
+        {
+            task_out.write("SPAN", 4);
+            task_out.writeRaw<uint32_t>(VERSION);
+            if (job_out.file)
+            {
+                job_out.write("JOBS", 4);
+                job_out.writeRaw<uint32_t>(VERSION);
+            }
+        }
+        return ret;
+    }
+
+    void writeTask(const std::string &task, const std::string &DC,
+                   double start, double transfer, double run_time)
+    {
+        if (!task_out.file)
+            return;
+        if (format == CSV)
+        {
+            Writer &w = task_out;
+            w.write(task.data(), task.size());
+            w.write(",", 1);
+            w.write(DC.data(), DC.size());
+            w.write(",", 1);
+            w.writeDouble(start);
+            w.write(",", 1);
+            w.writeDouble(transfer);
+            w.write(",", 1);
+            w.writeDouble(run_time);
+            w.write("\n", 1);
+            return;
+        }
+        auto iter = DC_id.find(DC);
+        if (iter == DC_id.end())
+        {
+            iter = DC_id.emplace(DC, DC_id.size()).first;
+            new_DC.push_back(DC);
+        }
+        task_name.push_back(task);
+        task_DC.push_back(iter->second);
+        task_start.push_back(start);
+        task_transfer.push_back(transfer);
+        task_run.push_back(run_time);
+        if (task_name.size() >= BLOCK_ROWS)
+            flushTaskBlock();
+    }
+
+    void writeJob(const std::string &job, double finish_time)
+    {
+        if (!job_out.file)
+            return;
+        if (format == CSV)
+        {
+            char tmp[32];
+            int n = snprintf(tmp, sizeof(tmp), " %.4g\n", finish_time);
+            job_out.write(job.data(), job.size());
+            job_out.write(tmp, n);
+            return;
+        }
+        job_name.push_back(job);
+        job_finish.push_back(finish_time);
+        if (job_name.size() >= BLOCK_ROWS)
+            flushJobBlock();
+    }
+
+    void close()
+    {
+        if (format == BINARY)
+        {
+            flushTaskBlock();
+            flushJobBlock();
+        }
+        task_out.close();
+        job_out.close();
+    }
+};
+
+#endif
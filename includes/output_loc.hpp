@@ -0,0 +1,100 @@
+#ifndef __OUTPUT_LOC_HPP__
+#define __OUTPUT_LOC_HPP__
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// DC of each finished task's output, shared between forks
+//  entries since last fork are own, fork() freezes them
+//  into a layer which the fork and the original both read
+//  a layer read by others is never changed, it is copied
+// a layer is merged into the older one when that one is
+//  not 4 times larger, so there are O(log n) layers,
+//  fork() is O(log n) and each entry is copied O(log n) times
+// e.g. output_loc.set("tA1","DC2"), *output_loc.find("tA1")=="DC2"
+class OutputLoc
+{
+private:
+    typedef std::unordered_map<std::string, std::string> Layer;
+
+    // oldest first
+    //  mutable, as freezing does not change what is stored
+    mutable std::vector<std::shared_ptr<Layer>> layers;
+    mutable Layer own;
+
+    // own becomes a layer, merged with smaller older ones
+    void freeze() const
+    {
+        if (own.empty())
+            return;
+        layers.push_back(std::make_shared<Layer>(std::move(own)));
+        own.clear();
+        while (layers.size() > 1 &&
+               layers[layers.size() - 2]->size() <=
+                   4 * layers.back()->size())
+        {
+            auto newer = layers.back();
+            layers.pop_back();
+            auto &older = layers.back();
+            if (older.use_count() > 1)
+                older = std::make_shared<Layer>(*older);
+            // newer wins if a task is set again
+            for (const auto &it : *newer)
+                (*older)[it.first] = it.second;
+        }
+    }
+
+public:
+    // nullptr if task has not finished
+    const std::string *find(const std::string &task) const
+    {
+        auto iter = own.find(task);
+        if (iter != own.end())
+            return &iter->second;
+        for (int i = (int)layers.size() - 1; i >= 0; --i)
+        {
+            iter = layers[i]->find(task);
+            if (iter != layers[i]->end())
+                return &iter->second;
+        }
+        return nullptr;
+    }
+
+    bool count(const std::string &task) const
+    {
+        return find(task) != nullptr;
+    }
+
+    void set(const std::string &task, const std::string &DC)
+    {
+        own[task] = DC;
+    }
+
+    // free entry of a retired task
+    //  a layer read by a fork is copied first
+    void erase(const std::string &task)
+    {
+        own.erase(task);
+        // older layers may hold it too, if set again
+        for (auto &layer : layers)
+            if (layer->find(task) != layer->end())
+            {
+                if (layer.use_count() > 1)
+                    layer = std::make_shared<Layer>(*layer);
+                layer->erase(task);
+            }
+    }
+
+    // same entries, layers shared
+    OutputLoc fork() const
+    {
+        freeze();
+        OutputLoc ret;
+        ret.layers = layers;
+        return ret;
+    }
+};
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef __PAIR_FLOW_HPP__
+#define __PAIR_FLOW_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// max flow between every pair of DCs over direct links
+//  a transfer striped over disjoint paths gets the sum
+//  of their bandwidth, not only the widest one
+// e.g. links DC1->DC2 100, DC1->DC3 50, DC3->DC2 80
+//  flow[0][1]=150, the widest path gives only 100
+// most pairs need no flow of their own, they are known
+//  once a lower bound meets an upper bound:
+//  upper: out of u, into v, and every min cut found,
+//   a cut separating u from v bounds flow[u][v]
+//  lower: widest path, paths of two hops, and
+//   flow[u][v] >= min(flow[u][k], flow[k][v]),
+//   a cut between u and v separates u from k or k from v
+// sources go to threads, which share the bounds
+class PairFlows
+{
+private:
+    static constexpr double eps = 1e-9;
+
+    int n;
+    // links in CSR, arc a is u->to[a] and rev[a] is v->u
+    std::vector<int> begin, to, rev;
+    std::vector<double> cap;
+    // arc of link i->j, -1 if there is none
+    std::vector<std::vector<int>> arc;
+
+    // bounds of pair (i,j) at i*n+j, only move towards the flow
+    //  so a stale one read by another thread is still a bound
+    std::vector<std::atomic<double>> low, up;
+
+    static double get(const std::atomic<double> &x)
+    {
+        return x.load(std::memory_order_relaxed);
+    }
+
+    // raise a lower bound, or lower an upper one if sign < 0
+    static void tighten(std::atomic<double> &x, double v, int sign = 1)
+    {
+        double cur = get(x);
+        while (sign * (v - cur) > 0 &&
+               !x.compare_exchange_weak(cur, v, std::memory_order_relaxed))
+            ;
+    }
+
+    // buffers of a thread
+    struct Work
+    {
+        std::vector<double> res;
+        std::vector<int> level, iter, queue;
+        // level[] marks the source side of a min cut
+        bool cut = false;
+        // pairs needing Dinic
+        long long dinic = 0;
+    };
+
+    bool bfs(Work &w, int s, int t) const
+    {
+        std::fill(w.level.begin(), w.level.end(), -1);
+        int head = 0, tail = 0;
+        w.queue[tail++] = s;
+        w.level[s] = 0;
+        while (head < tail)
+        {
+            int x = w.queue[head++];
+            for (int a = begin[x]; a < begin[x + 1]; ++a)
+                if (w.res[a] > eps && w.level[to[a]] < 0)
+                {
+                    w.level[to[a]] = w.level[x] + 1;
+                    w.queue[tail++] = to[a];
+                }
+        }
+        return w.level[t] >= 0;
+    }
+
+    double dfs(Work &w, int x, int t, double f) const
+    {
+        if (x == t)
+            return f;
+        for (int &a = w.iter[x]; a < begin[x + 1]; ++a)
+        {
+            int y = to[a];
+            if (w.res[a] <= eps || w.level[y] != w.level[x] + 1)
+                continue;
+            double d = dfs(w, y, t, std::min(f, w.res[a]));
+            if (d > eps)
+            {
+                w.res[a] -= d;
+                w.res[rev[a]] += d;
+                return d;
+            }
+        }
+        return 0;
+    }
+
+    // paths s->t and s->k->t share no links, so their
+    //  widths are a flow at once, O(n)
+    //  pushed into w.res if push
+    double twoHop(Work &w, int s, int t, bool push) const
+    {
+        double ret = 0;
+        auto send = [&](int a, double f)
+        {
+            if (!push)
+                return;
+            w.res[a] -= f;
+            w.res[rev[a]] += f;
+        };
+        if (arc[s][t] >= 0)
+        {
+            ret += cap[arc[s][t]];
+            send(arc[s][t], cap[arc[s][t]]);
+        }
+        for (int k = 0; k < n; ++k)
+        {
+            int a = arc[s][k], b = arc[k][t];
+            if (k == s || k == t || a < 0 || b < 0)
+                continue;
+            double f = std::min(cap[a], cap[b]);
+            ret += f;
+            send(a, f), send(b, f);
+        }
+        return ret;
+    }
+
+    // Dinic from twoHop(), stops at bound
+    double maxFlow(Work &w, int s, int t, double bound) const
+    {
+        w.dinic++;
+        w.cut = false;
+        w.res = cap;
+        double ret = twoHop(w, s, t, true);
+        while (ret < bound - eps)
+        {
+            if (!bfs(w, s, t))
+            {
+                w.cut = true;
+                break;
+            }
+            for (int x = 0; x < n; ++x)
+                w.iter[x] = begin[x];
+            double f;
+            while ((f = dfs(w, s, t, 1e300)) > eps)
+                ret += f;
+        }
+        return ret;
+    }
+
+    // pairs of source s
+    void solveRow(Work &w, int s, std::vector<double> &flow)
+    {
+        const int row = s * n;
+        for (int t = 0; t < n; ++t)
+            if (t != s)
+                tighten(low[row + t], twoHop(w, s, t, false));
+        for (int t = 0; t < n; ++t)
+        {
+            if (t == s || get(low[row + t]) >= get(up[row + t]) - eps)
+                continue;
+            double f = maxFlow(w, s, t, get(up[row + t]));
+            tighten(low[row + t], f);
+            tighten(up[row + t], f, -1);
+            // source side to sink side
+            if (w.cut)
+                for (int a = 0; a < n; ++a)
+                    if (w.level[a] >= 0)
+                        for (int b = 0; b < n; ++b)
+                            if (w.level[b] < 0)
+                                tighten(up[a * n + b], f, -1);
+            // through t and through s
+            for (int b = 0; b < n; ++b)
+            {
+                tighten(low[row + b], std::min(f, get(low[t * n + b])));
+                tighten(low[b * n + t], std::min(get(low[b * n + s]), f));
+            }
+        }
+        // bounds met, by flow or not
+        for (int t = 0; t < n; ++t)
+            if (t != s)
+                flow[t] = get(low[row + t]);
+    }
+
+public:
+    // pairs needing Dinic, others were bounded
+    long long solved = 0;
+
+    // bandwidth[i][j] of link i->j, <= 0 if there is none
+    // widest[i][j] of widest path, a lower bound
+    // flow[i][j] is max flow, flow[i][i] is bandwidth[i][i]
+    std::vector<std::vector<double>> build(
+        const std::vector<std::vector<double>> &bandwidth,
+        const std::vector<std::vector<double>> &widest,
+        int threads = 0)
+    {
+        n = bandwidth.size();
+        arc.assign(n, std::vector<int>(n, -1));
+        begin.assign(n + 1, 0);
+        to.clear(), rev.clear(), cap.clear();
+        // bandwidth out of and into each DC
+        std::vector<double> out(n, 0), in(n, 0);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                if (i != j && bandwidth[i][j] > 0)
+                {
+                    begin[i + 1]++, begin[j + 1]++;
+                    out[i] += bandwidth[i][j];
+                    in[j] += bandwidth[i][j];
+                }
+        for (int i = 0; i < n; ++i)
+            begin[i + 1] += begin[i];
+        to.resize(begin[n]), rev.resize(begin[n]), cap.resize(begin[n]);
+        std::vector<int> pos(begin.begin(), begin.end() - 1);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                if (i != j && bandwidth[i][j] > 0)
+                {
+                    int a = pos[i]++, b = pos[j]++;
+                    arc[i][j] = a;
+                    to[a] = j, cap[a] = bandwidth[i][j], rev[a] = b;
+                    to[b] = i, cap[b] = 0, rev[b] = a;
+                }
+
+        low = std::vector<std::atomic<double>>(n * n);
+        up = std::vector<std::atomic<double>>(n * n);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+            {
+                low[i * n + j].store(std::max(widest[i][j], 0.0));
+                up[i * n + j].store(std::min(out[i], in[j]));
+            }
+
+        std::vector<std::vector<double>> flow(n, std::vector<double>(n));
+        for (int i = 0; i < n; ++i)
+            flow[i][i] = bandwidth[i][i];
+        std::atomic<int> next(0);
+        std::atomic<long long> cnt(0);
+        auto worker = [&]()
+        {
+            Work w;
+            w.level.resize(n), w.iter.resize(n), w.queue.resize(n);
+            for (int i; (i = next++) < n;)
+                solveRow(w, i, flow[i]);
+            cnt += w.dinic;
+        };
+        if (threads <= 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, std::max(n, 1));
+        std::vector<std::thread> pool;
+        for (int k = 1; k < threads; ++k)
+            pool.emplace_back(worker);
+        worker();
+        for (auto &it : pool)
+            it.join();
+        solved = cnt;
+        return flow;
+    }
+};
+
+#endif
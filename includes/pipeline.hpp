@@ -0,0 +1,130 @@
+#ifndef __PIPELINE_HPP__
+#define __PIPELINE_HPP__
+
+#include <chrono>
+#include <future>
+#include "common.hpp"
+#include "scheduler.hpp"
+
+// a scheduling round solved on a worker thread
+//  while the simulator keeps running
+//
+// the round schedules a fork of graph taken at its start,
+//  tasks finishing meanwhile only free slots for next round
+// solving takes latency_scale * wall time in simulator,
+//  decisions are applied at start + that, see applyTime()
+// for policies without state between rounds:
+//  GREEDY, K_GREEDY, RANDOM, NETWORK_SUM and NETWORK_NECK
+class AsyncScheduler
+{
+private:
+    typedef pair<double, pair<string, string>> Arrange;
+    typedef std::chrono::steady_clock Clock;
+
+    Scheduler *scheduler = nullptr;
+    shared_ptr<Graph> graph;
+
+    std::future<vector<Arrange>> job;
+    // simulator time and wall time the round started
+    double start_time = 0;
+    Clock::time_point start_wall;
+    // wall time the round finished
+    //  written by worker before job is ready
+    Clock::time_point end_wall;
+
+    static double seconds(Clock::duration d)
+    {
+        return std::chrono::duration<double>(d).count();
+    }
+
+public:
+    // simulator seconds per wall second of solving
+    //  e.g. 100 for a cluster 100 times larger than the workload
+    double latency_scale = 1;
+
+    // -----> statistics begin
+    int rounds = 0;
+    // wall seconds of all rounds
+    double latency = 0;
+    double max_latency = 0;
+    // assignments dropped as state changed during the round
+    int conflicts = 0;
+    // <----- statistics end
+
+    void init(Scheduler *scheduler, shared_ptr<Graph> graph)
+    {
+        this->scheduler = scheduler;
+        this->graph = graph;
+    }
+
+    // whether a round is started and not finished
+    bool busy() const
+    {
+        return job.valid();
+    }
+
+    bool ready() const
+    {
+        return job.wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready;
+    }
+
+    // schedule ready tasks on a fork at simulator time now
+    //  ready tasks are kept until finish()
+    void start(double now)
+    {
+        Scheduler fork_sched = scheduler->fork(graph->fork());
+        start_time = now;
+        start_wall = Clock::now();
+        job = std::async(std::launch::async,
+                         [this, fork_sched]() mutable
+                         {
+                             auto ret = fork_sched.getScheduled();
+                             end_wall = Clock::now();
+                             return ret;
+                         });
+    }
+
+    // simulator time decisions are applied
+    //  a lower bound growing with wall time if not ready
+    double applyTime() const
+    {
+        Clock::time_point end = ready() ? end_wall : Clock::now();
+        return start_time + latency_scale * seconds(end - start_wall);
+    }
+
+    // sleep until ready or simulator time t is reached
+    void waitUntil(double t) const
+    {
+        double wall = latency_scale > 0
+                          ? (t - start_time) / latency_scale
+                          : std::numeric_limits<double>::max();
+        // an hour is forever
+        if (wall > 3600)
+            job.wait();
+        else
+            job.wait_until(start_wall +
+                           std::chrono::duration_cast<Clock::duration>(
+                               std::chrono::duration<double>(wall)));
+    }
+
+    // decisions still fitting graph, to apply at applyTime()
+    //  others are ready again for next round
+    vector<Arrange> finish()
+    {
+        auto sched = job.get();
+        double wall = seconds(end_wall - start_wall);
+        rounds++;
+        latency += wall;
+        max_latency = std::max(max_latency, wall);
+        // getScheduled() of fork counted CPU time of both threads
+        graph->stats.sched_time += wall;
+        graph->stats.rounds++;
+
+        auto ret = scheduler->commitScheduled(sched);
+        conflicts += sched.size() - ret.size();
+        return ret;
+    }
+};
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef __REGION_HPP__
+#define __REGION_HPP__
+
+#include "common.hpp"
+
+// DCs grouped into regions by bandwidth
+//
+// build a maximum spanning tree of bandwidth (Prim, O(DC^2)),
+//  the widest path between two DCs is the path on this tree,
+//  then cut its count-1 narrowest edges,
+//  each remaining tree is a region (single linkage clustering)
+// center of a region is the DC whose slowest link
+//  to others in the region is the fastest
+class RegionMap
+{
+private:
+    typedef pair<int, unordered_set<string>> Slot;
+
+    // graph regions are built for
+    const Graph *owner = nullptr;
+    // e.g. {{"DC1","DC3"},{"DC2"}}
+    vector<vector<string>> regions;
+    // e.g. {"DC3",0}
+    //  DC3 is in 0th region
+    unordered_map<string, int> region_id;
+    // e.g. {"DC1","DC2"}
+    vector<string> centers;
+    // slots of DCs in each region, same order as regions
+    //  elements of graph->slots never move
+    vector<vector<const Slot *>> slot_refs;
+
+public:
+    // group DCs of graph into count regions
+    //  count is sqrt(DCs) if not positive
+    void build(shared_ptr<Graph> graph, int count = 0)
+    {
+        owner = graph.get();
+        const auto &edges = graph->workload->edges;
+        vector<string> DCs;
+        for (const auto &slot : graph->slots)
+            DCs.push_back(slot.first);
+        std::sort(DCs.begin(), DCs.end());
+        int n = DCs.size();
+        if (count <= 0)
+            count = std::max(1, (int)std::round(std::sqrt(n)));
+        count = std::min(count, std::max(n, 1));
+
+        // cost is 1/bandwidth, so maximum spanning tree of
+        //  bandwidth is minimum spanning tree of cost
+        // e.g. {0.01,{0,2}}
+        vector<pair<double, pair<int, int>>> tree;
+        vector<double> dis(n, std::numeric_limits<double>::max());
+        vector<int> from(n, -1);
+        vector<bool> in_tree(n, false);
+        for (int i = 0; i < n; ++i)
+        {
+            int x = -1;
+            for (int j = 0; j < n; ++j)
+                if (!in_tree[j] && (x == -1 || dis[j] < dis[x]))
+                    x = j;
+            in_tree[x] = true;
+            if (from[x] != -1)
+                tree.push_back(make_pair(dis[x], make_pair(from[x], x)));
+            const auto &row = edges.at(DCs[x]);
+            for (int j = 0; j < n; ++j)
+            {
+                if (in_tree[j])
+                    continue;
+                double d = row.at(DCs[j]);
+                if (d < dis[j])
+                    dis[j] = d, from[j] = x;
+            }
+        }
+
+        // keep n-count fastest edges
+        std::sort(tree.begin(), tree.end());
+        UnionFindSet g;
+        g.init(n);
+        for (int i = 0; i < n - count && i < tree.size(); ++i)
+            g.unite(tree[i].second.first, tree[i].second.second);
+
+        regions.clear();
+        region_id.clear();
+        unordered_map<int, int> root_id;
+        for (int i = 0; i < n; ++i)
+        {
+            int root = g.find(i);
+            if (root_id.find(root) == root_id.end())
+            {
+                root_id[root] = regions.size();
+                regions.push_back({});
+            }
+            regions[root_id[root]].push_back(DCs[i]);
+            region_id[DCs[i]] = root_id[root];
+        }
+
+        slot_refs.clear();
+        for (const auto &region : regions)
+        {
+            slot_refs.push_back({});
+            for (const auto &DC : region)
+                slot_refs.back().push_back(&graph->slots.at(DC));
+        }
+
+        centers.clear();
+        for (const auto &region : regions)
+        {
+            string best;
+            double best_val = std::numeric_limits<double>::max();
+            for (const auto &u : region)
+            {
+                double val = 0;
+                for (const auto &v : region)
+                    val = std::max(val, edges.at(u).at(v));
+                if (val < best_val)
+                    best_val = val, best = u;
+            }
+            centers.push_back(best);
+        }
+    }
+
+    // whether regions are built for graph
+    bool builtFor(const shared_ptr<Graph> &graph) const
+    {
+        return owner == graph.get();
+    }
+
+    // free slots of k-th region
+    int freeSlots(int k) const
+    {
+        int ret = 0;
+        for (const auto &slot : slot_refs[k])
+            ret += std::max(0, slot->first - (int)slot->second.size());
+        return ret;
+    }
+
+    int size() const
+    {
+        return regions.size();
+    }
+
+    const vector<string> &region(int k) const
+    {
+        return regions[k];
+    }
+
+    const string &center(int k) const
+    {
+        return centers[k];
+    }
+
+    int regionOf(const string &DC) const
+    {
+        return region_id.at(DC);
+    }
+};
+
+#endif
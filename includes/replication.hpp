@@ -0,0 +1,205 @@
+#ifndef __REPLICATION_HPP__
+#define __REPLICATION_HPP__
+
+#include "common.hpp"
+
+// choose extra DCs for hot resources in DC.json
+//  and put them into workload->replica_loc
+//
+// a task may run on any DC, DC with more slots more likely
+//  so reading resource r once costs
+//      size(r) * sum over DC x of p(x) * min edges[loc][x]
+//  where p(x) is slots of x over all slots
+//      and loc is the primary DC or a replica of r
+// replicas with the largest saving per size are taken greedily
+//  until storage of every DC is used up
+//
+// note: workload is shared by forks, so run plan()
+//  only when no rollout is running
+class ReplicationPlanner
+{
+private:
+    typedef pair<double, pair<string, string>> Candidate;
+    // pair<saving per size,pair<resource(A1),DC(DC3)>>
+
+    shared_ptr<Graph> graph;
+
+    // e.g. {"DC1",0.25}
+    //  a task runs on DC1 with probability 0.25
+    unordered_map<string, double> prob;
+
+    // storage used by replicas on DC
+    unordered_map<string, double> used;
+
+    // storage of DC from DC.json
+    // e.g. {"DC1",1000}
+    unordered_map<string, double> storage;
+
+    // reads and size of resource by unfinished tasks
+    // e.g. {"A1",{3,150}}
+    //  A1 of size 150 is read 3 times
+    unordered_map<string, pair<int, double>> heat;
+
+private:
+    // cost of reading resource once on DC x
+    //  from the nearest copy
+    double readCost(const string &resource, const string &x)
+    {
+        const Workload &work = *graph->workload;
+        double ret = work.edges.at(work.resource_loc.at(resource)).at(x);
+        auto replicas = work.replica_loc.find(resource);
+        if (replicas != work.replica_loc.end())
+            for (const auto &replica : replicas->second)
+                ret = std::min(ret, work.edges.at(replica).at(x));
+        return ret;
+    }
+
+    // expected saving of all reads if resource is copied to DC
+    double saving(const string &resource, const string &DC)
+    {
+        const auto &edges = graph->workload->edges;
+        double ret = 0;
+        for (const auto &it : prob)
+        {
+            double now = readCost(resource, it.first);
+            double after = edges.at(DC).at(it.first);
+            if (after < now)
+                ret += it.second * (now - after);
+        }
+        const auto &h = heat[resource];
+        return ret * h.first * h.second;
+    }
+
+    double capacity(const string &DC)
+    {
+        auto iter = storage.find(DC);
+        return iter == storage.end() ? budget : iter->second;
+    }
+
+    bool hasCopy(const string &resource, const string &DC)
+    {
+        const Workload &work = *graph->workload;
+        if (work.resource_loc.at(resource) == DC)
+            return true;
+        auto replicas = work.replica_loc.find(resource);
+        if (replicas == work.replica_loc.end())
+            return false;
+        const auto &locs = replicas->second;
+        return std::find(locs.begin(), locs.end(), DC) != locs.end();
+    }
+
+public:
+    // storage for replicas of each DC, in the unit of resource size
+    //  "storage" of DC in DC.json overrides it
+    double budget = 500;
+    // replicas of a resource at most
+    int max_replicas = 2;
+
+    // replicas added by plan()
+    int added = 0;
+
+    void initGraph(shared_ptr<Graph> graph)
+    {
+        this->graph = graph;
+        prob.clear();
+        int total = 0;
+        for (const auto &slot : graph->slots)
+            total += slot.second.first;
+        for (const auto &slot : graph->slots)
+            prob[slot.first] = total == 0 ? 0
+                                          : slot.second.first / double(total);
+    }
+
+    // storage of each DC from DC.json
+    // e.g. {"name":"DC1","size":2,"storage":1000,"data":[...]}
+    void initStorage()
+    {
+        json DC;
+        std::ifstream DC_file(DIR + "DC.json");
+        if (!DC_file.is_open())
+            printError("No DC.json");
+        DC_file >> DC;
+        DC_file.close();
+        for (const auto &it : DC["DC"])
+            if (it.find("storage") != it.end())
+                storage[it["name"]] = it["storage"];
+    }
+
+    // expected transfer time of all unfinished tasks
+    //  with current replicas
+    double estimate()
+    {
+        double ret = 0;
+        for (const auto &job : graph->job_task)
+            for (const auto &task : job.second)
+                for (const auto &it : prob)
+                    ret += it.second * graph->transferTime(task, it.first);
+        return ret;
+    }
+
+    // add replicas for unfinished tasks
+    //  call again after jobs arrive, replicas are kept
+    void plan()
+    {
+        const Workload &work = *graph->workload;
+        heat.clear();
+        for (const auto &job : graph->job_task)
+            for (const auto &task : job.second)
+            {
+                auto resource_requires = work.require.find(task);
+                if (resource_requires == work.require.end())
+                    continue;
+                for (const auto &it : resource_requires->second)
+                {
+                    // outputs of tasks are not replicated
+                    if (work.resource_loc.find(it.first) ==
+                        work.resource_loc.end())
+                        continue;
+                    auto &h = heat[it.first];
+                    h.first++;
+                    h.second = std::max(h.second, it.second);
+                }
+            }
+
+        priority_queue<Candidate> Q;
+        for (const auto &h : heat)
+            for (const auto &it : prob)
+            {
+                if (hasCopy(h.first, it.first))
+                    continue;
+                double s = saving(h.first, it.first);
+                if (s > 0)
+                    Q.push(make_pair(s / std::max(h.second.second, 1e-9),
+                                     make_pair(h.first, it.first)));
+            }
+
+        // lazy greedy: saving only drops as replicas are added
+        //  so recompute the top and take it if it is still the top
+        auto &replicas = graph->workload->replica_loc;
+        while (!Q.empty())
+        {
+            Candidate top = Q.top();
+            Q.pop();
+            string resource = top.second.first;
+            string DC = top.second.second;
+            double size = heat[resource].second;
+            if (hasCopy(resource, DC) ||
+                replicas[resource].size() >= max_replicas ||
+                used[DC] + size > capacity(DC))
+                continue;
+            double s = saving(resource, DC) / std::max(size, 1e-9);
+            if (s <= 0)
+                continue;
+            if (!Q.empty() && s < Q.top().first)
+            {
+                Q.push(make_pair(s, top.second));
+                continue;
+            }
+            replicas[resource].push_back(DC);
+            used[DC] += size;
+            added++;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef __RNG_HPP__
+#define __RNG_HPP__
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+// xoshiro256** generator
+//  seeded by splitmix64, so every (seed, component, replication)
+//  gives an independent stream
+// e.g. Rng(1, "k_greedy:tA1", 0)
+//  random numbers used by K_GREEDY for tA1 in replication 0
+//  same in every run with seed 1, whatever the other draws are,
+//  which gives common random numbers when comparing policies
+// it is a UniformRandomBitGenerator, so it works with <random>
+class Rng
+{
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    static uint64_t splitmix64(uint64_t &x)
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // FNV-1a
+    static uint64_t hashString(const std::string &str)
+    {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char c : str)
+            h = (h ^ c) * 0x100000001b3ULL;
+        return h;
+    }
+
+public:
+    typedef uint64_t result_type;
+
+    Rng(uint64_t seed = 0,
+        const std::string &component = "",
+        uint64_t replication = 0)
+    {
+        this->seed(seed, component, replication);
+    }
+
+    void seed(uint64_t seed,
+              const std::string &component = "",
+              uint64_t replication = 0)
+    {
+        uint64_t x = seed;
+        x ^= splitmix64(x) ^ hashString(component);
+        x ^= splitmix64(x) ^ replication;
+        for (int i = 0; i < 4; ++i)
+            s[i] = splitmix64(x);
+    }
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    result_type operator()()
+    {
+        const uint64_t ret = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return ret;
+    }
+
+    // uniformly random int in [mn, mx]
+    //  without modulo bias
+    int randInt(int mn, int mx)
+    {
+        uint64_t range = uint64_t(int64_t(mx) - mn) + 1;
+        uint64_t limit = max() - max() % range;
+        uint64_t x;
+        do
+            x = (*this)();
+        while (x >= limit);
+        return mn + int64_t(x % range);
+    }
+
+    // uniformly random double in [0, 1)
+    double uniform()
+    {
+        return ((*this)() >> 11) * (1.0 / (1ULL << 53));
+    }
+};
+
+#endif
@@ -1,9 +1,16 @@
 #ifndef __SCHEDULER_HPP__
 #define __SCHEDULER_HPP__
 
+#include <chrono>
+#include <thread>
 #include "common.hpp"
 #include "network_neck.hpp"
 #include "network_sum.hpp"
+#include "DAG.hpp"
+#include "simulator.hpp"
+#include "mcts.hpp"
+#include "timer_wheel.hpp"
+#include "region.hpp"
 
 class Scheduler
 {
@@ -24,32 +31,174 @@ private:
         }
     };
 
+    // random streams of K_GREEDY and RANDOM
+    //  each task has its own stream, see initSeed()
+    uint64_t seed = time(0);
+    uint64_t replication = 0;
+
+    // running simulation, forked by rollouts
+    Simulator *sim = nullptr;
+    DAG *dag = nullptr;
+    // scheduling rounds so far
+    int round = 0;
+
+    // simulator time, see updateTime()
+    double now = 0;
+    // deadlines of tasks waiting for a local slot
+    //  used by DELAY
+    TimerWheel delay_timers;
+    // tasks waited longer than delay_wait
+    unordered_set<string> delay_expired;
+
+    // regions of DCs for HIERARCHY
+    //  built by initGraph(), or first round on a fork
+    RegionMap regions;
+
+    // resources taken by assignments of this round
+    // e.g. {"DC1",{1,{2,4}}}
+    //  one slot, 2 cpu and 4 mem of DC1
+    unordered_map<string, pair<int, vector<double>>> planned;
+
     // tasks are available but have not been scheduled
     unordered_set<string> ready_set;
     // same as ready_set but FIFO
     //  used by NetworkSched
     std::deque<string> ready_queue;
 
+    // transfer times of ready tasks, see count_time()
+    //  inputs of a ready task never move, so entries only
+    //  go stale when bandwidth changes, see updateLinks()
+    // a copy starts empty, so forks are not slowed down by it
+    struct CostCache
+    {
+        // e.g. cost["tA1"]["DC1"]=4
+        unordered_map<string, unordered_map<string, double>> cost;
+        // e.g. src["tA1"]={"DC2","DC5"}
+        //  inputs of tA1 are in DC2 and DC5
+        unordered_map<string, vector<string>> src;
+
+        CostCache() = default;
+        CostCache(const CostCache &) {}
+        CostCache &operator=(const CostCache &)
+        {
+            cost.clear();
+            src.clear();
+            return *this;
+        }
+    } cache;
+
 private:
     double count_time(const string &task_name,
                       const string &which_slot)
     {
-        vector<pair<string, double>>
-            resource_requires = graph->require[task_name];
-        double mx = 0;
-        for (const auto &resource : resource_requires)
+        // staged inputs take less as time goes, never cached
+        if (!graph->staged.empty())
+        {
+            auto stage = graph->staged.find(task_name);
+            if (stage != graph->staged.end() &&
+                stage->second.first == which_slot)
+                return graph->transferTime(task_name, which_slot, now);
+        }
+        auto &row = cache.cost[task_name];
+        auto iter = row.find(which_slot);
+        if (iter != row.end())
+        {
+            cost_hits++;
+            return iter->second;
+        }
+        if (row.empty())
+        {
+            cache.src[task_name] = graph->inputDCs(task_name);
+            row.reserve(graph->slots.size());
+        }
+        return row[which_slot] = graph->transferTime(task_name,
+                                                     which_slot);
+    }
+
+    // drop cached costs of tasks not ready any more
+    //  when there are many of them
+    void pruneCost()
+    {
+        if (cache.cost.size() <= 2 * ready_set.size() + 64)
+            return;
+        for (auto iter = cache.cost.begin(); iter != cache.cost.end();)
         {
-            // resource_position
-            string loc = graph->resource_loc[resource.first];
-            double bandwidth = graph->edges[loc][which_slot];
-            double cost = resource.second * bandwidth;
-            mx = std::max(mx, cost);
+            if (ready_set.find(iter->first) == ready_set.end())
+            {
+                cache.src.erase(iter->first);
+                iter = cache.cost.erase(iter);
+            }
+            else
+                ++iter;
         }
-        return mx;
+    }
+
+    // whether task fits in DC
+    //  besides running tasks and planned ones
+    bool canAdmit(const string &task, const string &DC)
+    {
+        auto &slot = graph->slots[DC];
+        auto &p = planned[DC];
+        return slot.first > slot.second.size() + p.first &&
+               graph->fits(task, DC, p.second);
+    }
+
+    void admit(const string &task, const string &DC)
+    {
+        auto &p = planned[DC];
+        p.first++;
+        graph->addDemand(p.second, task);
+    }
+
+    // keep assignments fitting in order
+    //  others move to the fitting DC with least transfer time,
+    //  or are ready again if no DC fits
+    // for policies only counting slots
+    vector<Arrange> admitAll(const vector<Arrange> &assigned)
+    {
+        planned.clear();
+        vector<Arrange> ret;
+        vector<string> rejected;
+        for (const auto &it : assigned)
+        {
+            const string &DC = it.second.first;
+            const string &task = it.second.second;
+            if (canAdmit(task, DC))
+            {
+                admit(task, DC);
+                ret.push_back(it);
+            }
+            else
+                rejected.push_back(task);
+        }
+        for (const auto &task : rejected)
+        {
+            Arrange best(std::numeric_limits<double>::max(),
+                         make_pair("", task));
+            for (const auto &slot : graph->slots)
+                if (canAdmit(task, slot.first))
+                {
+                    double ti = count_time(task, slot.first);
+                    if (ti < best.first)
+                        best = make_pair(ti, make_pair(slot.first, task));
+                }
+            if (best.second.first.empty())
+            {
+                ready_set.insert(task);
+                continue;
+            }
+            admit(task, best.second.first);
+            ret.push_back(best);
+        }
+        return ret;
     }
 
     // assign tasks using greedy approach
-    vector<Arrange> getGreedy()
+    // skip first 0~2 choices of each task if skip_key is not empty
+    //  drawn from stream skip_key + task
+    // with resource demands, prefer DCs whose free capacity
+    //  aligns with the demand (tetris), see packing_weight
+    vector<Arrange> getGreedy(const string &skip_key = "")
     {
         priority_queue<Arrange,
                        vector<Arrange>, ArrangeCompare>
@@ -61,10 +210,14 @@ private:
             for (const auto &slot : graph->slots)
             {
                 if (slot.second.second.size() <
-                    slot.second.first) // capacity>0
+                        slot.second.first && // capacity>0
+                    graph->fits(task_iter, slot.first))
                 {
                     Arrange this_method;
-                    this_method.first = count_time(task_iter, slot.first);
+                    this_method.first = count_time(task_iter, slot.first) -
+                                        packing_weight *
+                                            graph->alignment(task_iter,
+                                                             slot.first);
                     this_method.second.second = task_iter;
                     this_method.second.first = slot.first;
                     Q.push(this_method);
@@ -72,14 +225,14 @@ private:
             }
         }
 
-        // for K_GREEDY
+        // for K_GREEDY and BEST_OF_K
         // skip first k choices
         // (k=0 for normal greedy)
         unordered_map<string, int> k_val;
 
         vector<Arrange> assignments;
-        unordered_map<string, int> used;
         // some slots of graph arranged just now
+        planned.clear();
         while (!Q.empty())
         {
             Arrange assignment = Q.top();
@@ -90,18 +243,15 @@ private:
             if (ready_set.find(task) != ready_set.end())
             {
                 // tasks in ready_queue
-                // int DC_used = used.find(DC) == used.end() ? 0 : used[DC];
-                // map initialize int with 0
-                int DC_used = used[DC];
-                auto &slot = graph->slots[DC];
-
-                if (slot.first > slot.second.size() + DC_used)
+                if (canAdmit(task, DC))
                 {
-                    if (sched_type == K_GREEDY)
+                    if (!skip_key.empty())
                     {
                         // skip 0~2 choices
                         if (k_val.find(task) == k_val.end())
-                            k_val[task] = randInt(0, 2);
+                            k_val[task] = Rng(seed, skip_key + task,
+                                              replication)
+                                              .randInt(0, 2);
                         if (k_val[task] != 0)
                         {
                             k_val[task]--;
@@ -111,14 +261,335 @@ private:
                     // slots with enough capacity
                     // arrange successfully
                     ready_set.erase(task); // pop from ready_queue
+                    assignment.first = count_time(task, DC);
                     assignments.push_back(assignment);
-                    used[DC]++;
+                    admit(task, DC);
                 }
             }
         }
         return assignments;
     }
 
+    // draw num greedy assignments of ready_set
+    //  the first one skips nothing,
+    //  the k-th one skips with stream key + k
+    // ready_set is not changed
+    vector<vector<Arrange>> drawCandidates(int num, const string &key)
+    {
+        unordered_set<string> origin = ready_set;
+        vector<vector<Arrange>> candidates;
+        for (int k = 0; k < num; ++k)
+        {
+            ready_set = origin;
+            candidates.push_back(
+                getGreedy(k == 0 ? "" : key + std::to_string(k) + ":"));
+        }
+        ready_set = origin;
+        return candidates;
+    }
+
+    // simulate rollout_horizon seconds on forks after applying first
+    //  the i-th round after uses skip stream keys[i] of GREEDY
+    //  (no skip if empty), plain GREEDY after keys run out
+    // return sum of min(finish time, horizon) of known tasks
+    //  smaller is better
+    double rollout(const vector<Arrange> &first,
+                   const vector<string> &keys,
+                   shared_ptr<Graph> fork_graph)
+    {
+        Simulator fork_sim = sim->fork(fork_graph);
+        DAG fork_dag = dag->fork(fork_graph);
+        Scheduler fork_sched = fork(fork_graph);
+        fork_sched.sched_type = GREEDY;
+        for (const auto &it : first)
+            fork_sched.ready_set.erase(it.second.second);
+
+        double end_time = fork_sim.getTime() + rollout_horizon;
+        double score = 0;
+        int depth = 0;
+        fork_sim.updateScheduled(first);
+        while (!fork_dag.if_finished() && !fork_sim.isEmpty())
+        {
+            fork_sim.forwardTime();
+            if (fork_sim.getTime() > end_time)
+                break;
+            auto finished = fork_sim.getFinished();
+            for (const auto &it : finished)
+                score += it.second;
+            fork_dag.updateDAG(finished);
+            fork_sched.sumbitTasks(fork_dag.getSubmit());
+            string key = depth < keys.size() ? keys[depth++] : "";
+            fork_sim.updateScheduled(fork_sched.getGreedy(key));
+        }
+        // tasks not finished in horizon
+        score += fork_dag.taskSize() * end_time;
+        return score;
+    }
+
+    // draw best_k greedy assignments, the first one without skipping
+    //  evaluate them by rollout in parallel and commit the best
+    vector<Arrange> getBestOfK()
+    {
+        if (!sim || !dag)
+            printError("BEST_OF_K needs initLookahead()");
+        round++;
+        auto candidates = drawCandidates(
+            best_k, "best_of_k:" + std::to_string(round) + ":");
+        if (candidates[0].empty())
+            return candidates[0];
+
+        // threads only touch their own forks
+        //  and read the shared workload
+        vector<double> score(best_k);
+        vector<std::thread> workers;
+        for (int k = 0; k < best_k; ++k)
+            workers.emplace_back(
+                [this, k, &candidates, &score]()
+                {
+                    score[k] = rollout(candidates[k], {},
+                                       graph->fork());
+                });
+        for (auto &worker : workers)
+            worker.join();
+
+        int best = 0;
+        for (int k = 1; k < best_k; ++k)
+            if (score[k] < score[best])
+                best = k;
+        for (const auto &it : candidates[best])
+            ready_set.erase(it.second.second);
+        return candidates[best];
+    }
+
+    // search rounds ahead with MCTS for mcts_budget seconds
+    //  action k of a round is the k-th greedy candidate,
+    //  rollouts use GREEDY, then commit the best root action
+    vector<Arrange> getMCTS()
+    {
+        if (!sim || !dag)
+            printError("MCTS needs initLookahead()");
+        round++;
+        string prefix = "mcts:" + std::to_string(round) + ":";
+        auto candidates = drawCandidates(mcts_actions, prefix + "0:");
+        if (candidates[0].empty())
+            return candidates[0];
+
+        // path[0] is a root candidate, path[i] is the skip stream
+        //  of the i-th round after
+        auto evaluate = [this, &candidates, &prefix](const vector<int> &path)
+        {
+            vector<string> keys;
+            for (int i = 1; i < path.size(); ++i)
+                keys.push_back(path[i] == 0
+                                   ? ""
+                                   : prefix + std::to_string(i) + ":" +
+                                         std::to_string(path[i]) + ":");
+            return rollout(candidates[path[0]], keys, graph->fork());
+        };
+
+        MCTS tree;
+        tree.actions = mcts_actions;
+        tree.max_depth = mcts_depth;
+        int best = tree.search(evaluate, mcts_budget, mcts_threads);
+        mcts_iterations += tree.getIterations();
+
+        for (const auto &it : candidates[best])
+            ready_set.erase(it.second.second);
+        return candidates[best];
+    }
+
+    // greedy of tasks on DCs
+    //  same order as getGreedy() without skipping
+    //  only reads graph, so regions run it in parallel
+    vector<Arrange> greedyWithin(const vector<string> &tasks,
+                                 const vector<string> &DCs) const
+    {
+        priority_queue<Arrange,
+                       vector<Arrange>, ArrangeCompare>
+            Q;
+        for (const auto &task : tasks)
+            for (const auto &DC : DCs)
+            {
+                const auto &slot = graph->slots.at(DC);
+                if (slot.second.size() < slot.first &&
+                    graph->fits(task, DC))
+                    Q.push(make_pair(graph->transferTime(task, DC) -
+                                         packing_weight *
+                                             graph->alignment(task, DC),
+                                     make_pair(DC, task)));
+            }
+
+        vector<Arrange> assignments;
+        unordered_set<string> placed;
+        // resources taken in this call, see planned
+        unordered_map<string, pair<int, vector<double>>> taken;
+        while (!Q.empty())
+        {
+            Arrange assignment = Q.top();
+            Q.pop();
+            const string DC = assignment.second.first;
+            const string task = assignment.second.second;
+            if (placed.find(task) != placed.end())
+                continue;
+            const auto &slot = graph->slots.at(DC);
+            auto &t = taken[DC];
+            if (slot.first > slot.second.size() + t.first &&
+                graph->fits(task, DC, t.second))
+            {
+                placed.insert(task);
+                t.first++;
+                graph->addDemand(t.second, task);
+                assignment.first = graph->transferTime(task, DC);
+                assignments.push_back(assignment);
+            }
+        }
+        return assignments;
+    }
+
+    // two-level scheduling for many DCs
+    //  1. assign tasks to regions with NetworkSum,
+    //     a region is its center with free slots of all its DCs
+    //  2. GREEDY in each region, regions in parallel
+    // tasks not placed stay ready
+    vector<Arrange> getHierarchy()
+    {
+        if (!regions.builtFor(graph))
+            regions.build(graph, region_count);
+
+        // e.g. {{"DC1",2}}
+        //  region with center DC1 has 2 free slots
+        vector<pair<string, int>> cap_info;
+        int slots_cnt = 0;
+        for (int k = 0; k < regions.size(); ++k)
+        {
+            int free = regions.freeSlots(k);
+            if (free > 0)
+            {
+                cap_info.emplace_back(regions.center(k), free);
+                slots_cnt += free;
+            }
+        }
+        if (cap_info.empty() || ready_set.empty())
+            return vector<Arrange>();
+
+        vector<Arrange> assign_info;
+        for (const auto &task : ready_set)
+            for (const auto &it : cap_info)
+                assign_info.emplace_back(count_time(task, it.first),
+                                         make_pair(it.first, task));
+        NetworkSum net_sum;
+        net_sum.initNetwork(ready_set.size(),
+                            std::min(slots_cnt, (int)ready_set.size()),
+                            cap_info,
+                            assign_info);
+
+        vector<vector<string>> tasks(regions.size());
+        auto sched = net_sum.getSched();
+        for (const auto &it : sched)
+            tasks[regions.regionOf(it.second.first)].push_back(
+                it.second.second);
+
+        // k-th worker takes regions k, k+threads, ...
+        vector<vector<Arrange>> result(regions.size());
+        int threads = std::max(1, std::min(hierarchy_threads,
+                                           regions.size()));
+        if (sched.size() < hierarchy_inline)
+            threads = 1;
+        auto work = [this, threads, &tasks, &result](int id)
+        {
+            for (int k = id; k < regions.size(); k += threads)
+                if (!tasks[k].empty())
+                    result[k] = greedyWithin(tasks[k], regions.region(k));
+        };
+        vector<std::thread> workers;
+        for (int i = 1; i < threads; ++i)
+            workers.emplace_back(work, i);
+        work(0);
+        for (auto &worker : workers)
+            worker.join();
+
+        vector<Arrange> assignments;
+        for (const auto &it : result)
+            for (const auto &assignment : it)
+            {
+                ready_set.erase(assignment.second.second);
+                assignments.push_back(assignment);
+            }
+        return assignments;
+    }
+
+    // delay scheduling
+    //  a task only takes DCs within (1+delay_ratio) of its best
+    //  transfer time over all DCs, full or not
+    //  if they are full, it waits at most delay_wait seconds,
+    //  then takes any DC like GREEDY
+    vector<Arrange> getDelay()
+    {
+        for (const auto &task : delay_timers.advance(now))
+            delay_expired.insert(task);
+
+        // e.g. {"tA1",4.4}
+        //  tA1 only takes DCs transfer within 4.4s
+        unordered_map<string, double> limit;
+        priority_queue<Arrange,
+                       vector<Arrange>, ArrangeCompare>
+            Q;
+        for (const auto &task : ready_set)
+        {
+            double best = std::numeric_limits<double>::max();
+            for (const auto &slot : graph->slots)
+            {
+                if (slot.second.first == 0)
+                    continue;
+                double ti = count_time(task, slot.first);
+                best = std::min(best, ti);
+                if (slot.second.second.size() < slot.second.first &&
+                    graph->fits(task, slot.first))
+                    Q.push(make_pair(ti, make_pair(slot.first, task)));
+            }
+            if (delay_expired.find(task) == delay_expired.end())
+                limit[task] = best * (1 + delay_ratio) + 1e-8;
+        }
+
+        vector<Arrange> assignments;
+        planned.clear();
+        while (!Q.empty())
+        {
+            Arrange assignment = Q.top();
+            Q.pop();
+            string task = assignment.second.second;
+            string DC = assignment.second.first;
+            if (ready_set.find(task) == ready_set.end())
+                continue;
+            auto iter = limit.find(task);
+            if (iter != limit.end() && assignment.first > iter->second)
+                continue;
+            if (canAdmit(task, DC))
+            {
+                if (delay_timers.contains(task))
+                {
+                    // got a local slot after waiting
+                    delay_timers.cancel(task);
+                    delay_hits++;
+                }
+                delay_expired.erase(task);
+                ready_set.erase(task);
+                assignments.push_back(assignment);
+                admit(task, DC);
+            }
+        }
+
+        // tasks start waiting
+        for (const auto &task : ready_set)
+            if (delay_expired.find(task) == delay_expired.end() &&
+                !delay_timers.contains(task))
+            {
+                delay_timers.add(task, now + delay_wait);
+                delay_waits++;
+            }
+        return assignments;
+    }
+
     // assign tasks randomly
     vector<Arrange> getRandom()
     {
@@ -139,15 +610,27 @@ private:
         }
 
         vector<Arrange> assignments;
-        while (!ready_set.empty() &&
-               !available_slot.empty())
+        vector<string> tasks(ready_set.begin(), ready_set.end());
+        planned.clear();
+        for (const auto &task : tasks)
         {
-            string task = *ready_set.begin();
-            int DC_index = randInt(0,
-                                   available_slot.size() - 1);
+            if (available_slot.empty())
+                break;
+            // draw among DCs the task fits in
+            //  all available ones if it only takes a slot
+            vector<int> fitting;
+            for (int i = 0; i < available_slot.size(); ++i)
+                if (canAdmit(task, available_slot[i].first))
+                    fitting.push_back(i);
+            // not enough resources, wait for next round
+            if (fitting.empty())
+                continue;
+            int DC_index = fitting[Rng(seed, "random:" + task, replication)
+                                       .randInt(0, fitting.size() - 1)];
             // vector<pair<string, int>>::iterator
             auto iter = available_slot.begin() + DC_index;
             string DC = iter->first;
+            admit(task, DC);
             Arrange assignment;
             assignment.first = count_time(task, DC);
             assignment.second.first = DC;
@@ -163,6 +646,8 @@ private:
     }
 
     // use NetworkSum
+    // note: flows only count slots,
+    //  resource demands are checked by admitAll()
     vector<Arrange> getNetworkSum()
     {
         NetworkSum net_sum;
@@ -211,10 +696,11 @@ private:
         auto assigned = net_sum.getSched();
         for (const auto &it : assigned)
             ready_set.erase(it.second.second);
-        return assigned;
+        return admitAll(assigned);
     }
 
     // use NetworkNeck
+    // note: same as NetworkSum, see admitAll()
     vector<Arrange> getNetworkNeck()
     {
         NetworkNeck net_neck;
@@ -279,7 +765,7 @@ private:
                     slot.second.first)
                 {
                     double ti = count_time(task, slot.first) +
-                                graph->run_time[task];
+                                graph->workload->run_time.at(task);
                     assign_info.emplace_back(
                         make_pair(ti, make_pair(DC, task)));
                 }
@@ -292,7 +778,7 @@ private:
             unordered_map<string, int> job_id;
             for (const auto &task : assign_queue)
             {
-                string job = graph->which_job[task];
+                string job = graph->workload->which_job.at(task);
                 if (job_id.find(job) == job_id.end())
                 {
                     job_id[job] = task_group.size();
@@ -311,12 +797,16 @@ private:
             unordered_map<string, int> task_id;
             for (int i = 0; i < assign_queue.size(); ++i)
                 task_id[assign_queue[i]] = i;
+            const Workload &work = *graph->workload;
             for (const auto &task : assign_queue)
             {
+                auto next_nodes = work.next_nodes.find(task);
+                if (next_nodes == work.next_nodes.end())
+                    continue;
                 // next of this
-                for (const auto &next : graph->next_nodes[task])
+                for (const auto &next : next_nodes->second)
                     // prev of next
-                    for (const auto &prev : graph->prev_nodes[next])
+                    for (const auto &prev : work.prev_nodes.at(next))
                         if (task_id.find(prev) != task_id.end())
                         {
                             g.unite(task_id[prev], task_id[task]);
@@ -338,6 +828,7 @@ private:
         }
 
         net_neck.sched_type = NetworkNeck::FAIR;
+        net_neck.flow_type = neck_flow;
         net_neck.initNetwork(assign_queue.size(),
                              task_group,
                              cap_info,
@@ -347,10 +838,10 @@ private:
         for (auto &it : assigned)
         {
             string task = it.second.second;
-            it.first -= graph->run_time[task];
+            it.first -= graph->workload->run_time.at(task);
             ready_set.erase(task);
         }
-        return assigned;
+        return admitAll(assigned);
     }
 
 public:
@@ -360,18 +851,125 @@ public:
         K_GREEDY,
         RANDOM,
         NETWORK_SUM,
-        NETWORK_NECK
+        NETWORK_NECK,
+        BEST_OF_K,
+        MCTS_SEARCH,
+        DELAY,
+        HIERARCHY
     } sched_type;
 
+    // -----> BEST_OF_K begin
+    // number of candidate assignments per round
+    int best_k = 4;
+    // simulated seconds of each rollout
+    //  also used by MCTS_SEARCH
+    double rollout_horizon = 10;
+    // <----- BEST_OF_K end
+
+    // -----> MCTS_SEARCH begin
+    // candidates of each round
+    int mcts_actions = 4;
+    // rounds looked ahead
+    int mcts_depth = 3;
+    // seconds of search per round
+    double mcts_budget = 0.05;
+    int mcts_threads = std::max(1u, std::thread::hardware_concurrency());
+    // evaluations in all rounds
+    long long mcts_iterations = 0;
+    // <----- MCTS_SEARCH end
+
+    // seconds of transfer time one unit of alignment is worth
+    //  used by greedy policies with resource demands
+    double packing_weight = 1;
+
+    // -----> DELAY begin
+    // seconds a task waits for a local DC at most
+    double delay_wait = 1;
+    // DCs within (1+delay_ratio) of best transfer time are local
+    double delay_ratio = 0.1;
+    // tasks started waiting
+    long long delay_waits = 0;
+    // waiting tasks got a local DC before timeout
+    long long delay_hits = 0;
+    // <----- DELAY end
+
+    // -----> HIERARCHY begin
+    // regions of DCs, sqrt(DCs) if not positive
+    int region_count = 0;
+    // threads scheduling regions
+    int hierarchy_threads = std::max(1u, std::thread::hardware_concurrency());
+    // rounds placing fewer tasks solve regions on this thread,
+    //  starting threads takes longer than such a round
+    int hierarchy_inline = 64;
+    // <----- HIERARCHY end
+
     enum NeckType
     {
         SAME_TASK,
         SAME_NEXT
     } neck_type;
 
+    // max flow backend of NETWORK_NECK
+    NetworkNeck::FlowType neck_flow = NetworkNeck::MATCHING;
+
+    // cached transfer times used, and dropped by updateLinks()
+    long long cost_hits = 0;
+    long long cost_dropped = 0;
+
+    // tasks given a DC to stage inputs to, see getPrefetch()
+    long long prefetches = 0;
+
     void initGraph(shared_ptr<Graph> graph)
     {
         this->graph = graph;
+        // O(DCs^2) once, not in decision latency
+        if (sched_type == HIERARCHY)
+            regions.build(graph, region_count);
+    }
+
+    // copy of scheduler on a fork of graph
+    //  ready tasks are kept
+    Scheduler fork(shared_ptr<Graph> fork_graph) const
+    {
+        Scheduler ret = *this;
+        ret.graph = fork_graph;
+        return ret;
+    }
+
+    // state to fork rollouts from
+    //  used by BEST_OF_K and MCTS_SEARCH
+    void initLookahead(Simulator *sim, DAG *dag)
+    {
+        this->sim = sim;
+        this->dag = dag;
+    }
+
+    // same seed and replication give same random choices
+    //  for every task, whatever the order tasks come in
+    void initSeed(uint64_t seed, uint64_t replication = 0)
+    {
+        this->seed = seed;
+        this->replication = replication;
+    }
+
+    // current time of simulator
+    //  used by DELAY
+    void updateTime(double now)
+    {
+        this->now = now;
+    }
+
+    // earliest time a waiting task times out
+    //  max of double if no task is waiting
+    double nextWakeup()
+    {
+        return delay_timers.nextExpire();
+    }
+
+    // task is submitted and not scheduled yet
+    bool isReady(const string &task) const
+    {
+        return ready_set.find(task) != ready_set.end();
     }
 
     int taskSize()
@@ -383,6 +981,10 @@ public:
         case RANDOM:
         case NETWORK_SUM:
         case NETWORK_NECK:
+        case BEST_OF_K:
+        case MCTS_SEARCH:
+        case DELAY:
+        case HIERARCHY:
             return ready_set.size();
             // case NETWORK_NECK:
             // return ready_queue.size();
@@ -390,7 +992,9 @@ public:
     }
 
     // get new tasks from DAG
-    void sumbitTasks(unordered_set<string> tasks)
+    //  or any container of names, inserted in its order
+    template <class Tasks>
+    void sumbitTasks(const Tasks &tasks)
     {
         for (const auto &task : tasks)
         {
@@ -401,6 +1005,10 @@ public:
             case RANDOM:
             case NETWORK_SUM:
             case NETWORK_NECK:
+            case BEST_OF_K:
+            case MCTS_SEARCH:
+            case DELAY:
+            case HIERARCHY:
                 ready_set.insert(task);
                 break;
                 // case NETWORK_NECK:
@@ -411,17 +1019,174 @@ public:
         //add task into ready_queue
     }
 
+    // widest paths of DC pairs changed, see set_bandwidth()
+    //  drop cached costs reading inputs through them
+    // e.g. {{"DC2","DC3"}}
+    //  cost["tA1"]["DC3"] is dropped if tA1 reads from DC2
+    int updateLinks(const vector<pair<string, string>> &changed)
+    {
+        if (changed.empty() || cache.cost.empty())
+            return 0;
+        unordered_map<string, vector<string>> to;
+        for (const auto &it : changed)
+            to[it.first].push_back(it.second);
+        int ret = 0;
+        for (auto &it : cache.cost)
+            for (const auto &DC : cache.src[it.first])
+            {
+                auto iter = to.find(DC);
+                if (iter == to.end())
+                    continue;
+                for (const auto &dst : iter->second)
+                    ret += it.second.erase(dst);
+            }
+        cost_dropped += ret;
+        return ret;
+    }
+
+    // keep assignments of a fork still fitting this graph
+    //  kept tasks leave ready_set, others stay for next round
+    // e.g. a slot taken while the fork was scheduling
+    vector<Arrange> commitScheduled(const vector<Arrange> &sched)
+    {
+        planned.clear();
+        vector<Arrange> ret;
+        for (const auto &it : sched)
+        {
+            const string &DC = it.second.first;
+            const string &task = it.second.second;
+            if (ready_set.find(task) == ready_set.end() ||
+                !canAdmit(task, DC))
+                continue;
+            admit(task, DC);
+            ready_set.erase(task);
+            ret.push_back(it);
+        }
+        return ret;
+    }
+
+    // place backup copies of lagging tasks on free slots
+    //  of other DCs, least transfer time first
+    // e.g. {{"tA1","DC1"}} -> {{4,{"DC3","tA1"}}}
+    //  tA1 running on DC1 gets a backup on DC3
+    vector<Arrange> getBackups(const vector<pair<string, string>> &lagging)
+    {
+        planned.clear();
+        vector<Arrange> backups;
+        for (const auto &it : lagging)
+        {
+            const string &task = it.first;
+            Arrange best(std::numeric_limits<double>::max(),
+                         make_pair("", task));
+            for (const auto &slot : graph->slots)
+                if (slot.first != it.second && canAdmit(task, slot.first))
+                {
+                    double ti = count_time(task, slot.first);
+                    if (ti < best.first)
+                        best = make_pair(ti, make_pair(slot.first, task));
+                }
+            if (best.second.first.empty())
+                continue;
+            admit(task, best.second.first);
+            backups.push_back(best);
+        }
+        return backups;
+    }
+
+    // target DCs to stage static inputs of tasks
+    //  whose predecessors are nearly done, see getNearlyReady()
+    // the DC with least transfer time, taking outputs of
+    //  running predecessors as on their DC
+    //  it is tentative, no slot is held
+    // e.g. {"tA3"} -> {{"tA3","DC2"}}
+    vector<pair<string, string>> getPrefetch(const vector<string> &tasks)
+    {
+        vector<pair<string, string>> ret;
+        if (tasks.empty())
+            return ret;
+        // e.g. running["tA1"]="DC2"
+        unordered_map<string, string> running;
+        for (const auto &slot : graph->slots)
+            for (const auto &copy : slot.second.second)
+                running.emplace(copy, slot.first);
+        const Workload &work = *graph->workload;
+        for (const auto &task : tasks)
+        {
+            auto resource_requires = work.require.find(task);
+            if (resource_requires == work.require.end())
+                continue;
+            bool has_static = false;
+            for (const auto &resource : resource_requires->second)
+                has_static |= work.resource_loc.find(resource.first) !=
+                              work.resource_loc.end();
+            if (!has_static)
+                continue;
+            pair<double, string> best(std::numeric_limits<double>::max(), "");
+            for (const auto &slot : graph->slots)
+            {
+                if (slot.second.first <= 0)
+                    continue;
+                double mx = 0;
+                for (const auto &resource : resource_requires->second)
+                {
+                    const string *loc = graph->locate(resource.first);
+                    if (!loc)
+                    {
+                        auto iter = running.find(resource.first);
+                        if (iter == running.end())
+                            continue;
+                        loc = &iter->second;
+                    }
+                    mx = std::max(mx, graph->inputTime(resource.first,
+                                                       resource.second,
+                                                       *loc, slot.first));
+                }
+                if (mx < best.first)
+                    best = make_pair(mx, slot.first);
+            }
+            if (best.second.empty())
+                continue;
+            ret.emplace_back(task, best.second);
+            prefetches++;
+        }
+        return ret;
+    }
+
     // update current resources from simulator
     // schedule tasks to slots
     // e.g. {{4,{"DC1","tA1"}}}
     //  assign tA1 to DC1, takes 4s to transfer data
     vector<Arrange> getScheduled()
+    {
+        // wall time, so more threads do not count as more time
+        auto start = std::chrono::steady_clock::now();
+        vector<Arrange> ret = schedule();
+        pruneCost();
+        graph->stats.sched_time +=
+            std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+        graph->stats.rounds++;
+        return ret;
+    }
+
+private:
+    vector<Arrange> schedule()
     {
         switch (sched_type)
         {
         case GREEDY:
-        case K_GREEDY:
             return getGreedy();
+        case K_GREEDY:
+            return getGreedy("k_greedy:");
+        case BEST_OF_K:
+            return getBestOfK();
+        case MCTS_SEARCH:
+            return getMCTS();
+        case DELAY:
+            return getDelay();
+        case HIERARCHY:
+            return getHierarchy();
         case RANDOM:
             return getRandom();
         case NETWORK_NECK:
@@ -0,0 +1,687 @@
+#ifndef __SERVICE_HPP__
+#define __SERVICE_HPP__
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <climits>
+#include <cstring>
+#include "common.hpp"
+#include "scheduler.hpp"
+
+// scheduler as a service over a Unix domain socket
+//
+// a frame is the batch of messages of one scheduling tick
+//  u32 length of body, then body: varint count, messages
+// a message is u8 type, then its fields
+//  varint: 7 bits a byte, low bits first
+//  double: 8 bytes of IEEE 754, little endian
+//  name: varint id<<1 if sent before on this connection,
+//   else varint length<<1|1 and the bytes, which gets next id
+// each frame of client is answered by a frame of daemon
+//
+// requests
+//  SUBMIT    varint n, n task names: tasks become ready
+//            a task ready, running or finished is refused
+//  COMPLETE  varint n, n of (task, double finish time)
+//  SCHEDULE  double time: assign ready tasks
+//            once per frame, after other messages
+//  SLOTS     DC, varint slots, not fewer than running tasks
+//  BANDWIDTH DC u, DC v, double bandwidth (-1 if link is down)
+//            else finite and positive
+//            widest paths are updated incrementally
+//  SHUTDOWN
+// answers
+//  ASSIGN    double wakeup, varint n,
+//            n of (double transfer time, DC, task)
+//            wakeup is time to schedule again, max of double if none
+//  ERROR     string, message is skipped
+namespace service
+{
+    enum MessageType : uint8_t
+    {
+        SUBMIT = 1,
+        COMPLETE = 2,
+        SCHEDULE = 3,
+        SLOTS = 4,
+        BANDWIDTH = 5,
+        SHUTDOWN = 6,
+        ASSIGN = 16,
+        ERROR = 17
+    };
+
+    // larger frames are broken
+    //  a round of 100k tasks is about 2MB
+    const uint32_t MAX_FRAME = 16u << 20;
+
+    // messages of one frame
+    //  names sent are kept for the connection
+    class Writer
+    {
+    private:
+        string body;
+        int count = 0;
+        unordered_map<string, uint64_t> ids;
+
+    public:
+        void varint(uint64_t x)
+        {
+            for (; x >= 0x80; x >>= 7)
+                body.push_back(char((x & 0x7f) | 0x80));
+            body.push_back(char(x));
+        }
+
+        void real(double x)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &x, 8);
+            for (int i = 0; i < 8; ++i, bits >>= 8)
+                body.push_back(char(bits & 0xff));
+        }
+
+        void text(const string &s)
+        {
+            varint(s.size());
+            body += s;
+        }
+
+        void name(const string &s)
+        {
+            auto iter = ids.find(s);
+            if (iter != ids.end())
+                return varint(iter->second << 1);
+            varint(s.size() << 1 | 1);
+            body += s;
+            ids.emplace(s, ids.size());
+        }
+
+        // start a message
+        void type(MessageType t)
+        {
+            body.push_back(char(t));
+            count++;
+        }
+
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        // frame of messages so far, then start next frame
+        string frame()
+        {
+            string messages;
+            std::swap(messages, body);
+            varint(count);
+            messages = body + messages;
+            body.clear();
+            count = 0;
+            if (messages.size() > MAX_FRAME)
+                printError("Frame Too Large: " +
+                           std::to_string(messages.size()));
+            uint32_t len = messages.size();
+            string ret(4, 0);
+            for (int i = 0; i < 4; ++i)
+                ret[i] = char(len >> (8 * i) & 0xff);
+            return ret + messages;
+        }
+    };
+
+    // messages of one frame
+    //  ok() is false once it reads past the end
+    class Reader
+    {
+    private:
+        string body;
+        size_t pos = 0;
+        bool good = true;
+        vector<string> names;
+
+        // pos + n may wrap for a huge n from the peer
+        bool need(uint64_t n)
+        {
+            good &= n <= body.size() - pos;
+            return good;
+        }
+
+    public:
+        // returns number of messages
+        uint64_t load(string frame_body)
+        {
+            body = std::move(frame_body);
+            pos = 0;
+            good = true;
+            return varint();
+        }
+
+        bool ok() const
+        {
+            return good;
+        }
+
+        uint8_t byte()
+        {
+            return need(1) ? uint8_t(body[pos++]) : 0;
+        }
+
+        uint64_t varint()
+        {
+            uint64_t ret = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t b = byte();
+                ret |= uint64_t(b & 0x7f) << shift;
+                if (!(b & 0x80))
+                    return ret;
+            }
+            good = false;
+            return 0;
+        }
+
+        double real()
+        {
+            uint64_t bits = 0;
+            if (need(8))
+                for (int i = 0; i < 8; ++i)
+                    bits |= uint64_t(uint8_t(body[pos++])) << (8 * i);
+            double ret;
+            std::memcpy(&ret, &bits, 8);
+            return ret;
+        }
+
+        string text()
+        {
+            uint64_t len = varint();
+            if (!need(len))
+                return "";
+            pos += len;
+            return body.substr(pos - len, len);
+        }
+
+        string name()
+        {
+            uint64_t x = varint();
+            if (!(x & 1))
+            {
+                good &= (x >> 1) < names.size();
+                return good ? names[x >> 1] : "";
+            }
+            uint64_t len = x >> 1;
+            if (!need(len))
+                return "";
+            names.push_back(body.substr(pos, len));
+            pos += len;
+            return names.back();
+        }
+    };
+
+    // -----> socket begin
+    bool writeAll(int fd, const string &data)
+    {
+        size_t done = 0;
+        while (done < data.size())
+        {
+            // no SIGPIPE if peer is gone
+#ifdef MSG_NOSIGNAL
+            ssize_t n = ::send(fd, data.data() + done,
+                               data.size() - done, MSG_NOSIGNAL);
+#else
+            ssize_t n = ::send(fd, data.data() + done,
+                               data.size() - done, 0);
+#endif
+            if (n <= 0)
+                return false;
+            done += n;
+        }
+        return true;
+    }
+
+    bool readAll(int fd, char *data, size_t len)
+    {
+        size_t done = 0;
+        while (done < len)
+        {
+            ssize_t n = ::read(fd, data + done, len - done);
+            if (n <= 0)
+                return false;
+            done += n;
+        }
+        return true;
+    }
+
+    // body of next frame, false if closed or broken
+    bool readFrame(int fd, string &body)
+    {
+        unsigned char head[4];
+        if (!readAll(fd, (char *)head, 4))
+            return false;
+        uint32_t len = head[0] | head[1] << 8 |
+                       head[2] << 16 | uint32_t(head[3]) << 24;
+        if (len > MAX_FRAME)
+            return false;
+        body.resize(len);
+        return readAll(fd, &body[0], len);
+    }
+
+    sockaddr_un address(const string &path)
+    {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path))
+            printError("Socket Path Too Long: " + path);
+        std::strcpy(addr.sun_path, path.c_str());
+        return addr;
+    }
+    // <----- socket end
+}
+
+// read settings from file
+// e.g. "/tmp/scheduler.sock GREEDY"
+//  serve GREEDY on /tmp/scheduler.sock
+void read_service_settings(string &path, Scheduler &settings)
+{
+    const unordered_map<string, Scheduler::SchedType> policies = {
+        {"GREEDY", Scheduler::GREEDY},
+        {"K_GREEDY", Scheduler::K_GREEDY},
+        {"RANDOM", Scheduler::RANDOM},
+        {"NETWORK_SUM", Scheduler::NETWORK_SUM},
+        {"NETWORK_NECK", Scheduler::NETWORK_NECK},
+        {"DELAY", Scheduler::DELAY},
+        {"HIERARCHY", Scheduler::HIERARCHY}};
+    string policy = "GREEDY";
+    std::ifstream fin;
+    fin.open("service_settings.txt");
+    if (fin.is_open())
+        fin >> path >> policy;
+    if (policies.find(policy) == policies.end())
+        printError("Unsupported Service Policy: " + policy);
+    settings.sched_type = policies.at(policy);
+    settings.neck_type = Scheduler::SAME_NEXT;
+}
+
+// daemon keeping a Scheduler and its graph between calls
+//  the cluster manager runs tasks, daemon only tracks slots
+//  policies using simulator lookahead (BEST_OF_K, MCTS_SEARCH)
+//  are not supported
+class SchedulerService
+{
+private:
+    typedef pair<double, pair<string, string>> Arrange;
+
+    shared_ptr<Graph> graph;
+    Scheduler scheduler;
+
+    // DC and transfer time of running task
+    // e.g. running["tA1"]={"DC1",4}
+    unordered_map<string, pair<string, double>> running;
+
+    int listen_fd = -1;
+    string path;
+
+    void complete(const string &task, double time,
+                  service::Writer &out)
+    {
+        auto iter = running.find(task);
+        if (iter == running.end())
+        {
+            out.type(service::ERROR);
+            out.text("Task Not Running: " + task);
+            return;
+        }
+        const string &DC = iter->second.first;
+        graph->slots[DC].second.erase(task);
+        graph->addDemand(graph->usage[DC], task, -1);
+        graph->finishTask(task, DC, iter->second.second, time);
+        running.erase(iter);
+    }
+
+    // assign ready tasks and take their slots
+    void schedule(double time, service::Writer &out)
+    {
+        scheduler.updateTime(time);
+        auto sched = scheduler.getScheduled();
+        for (const auto &it : sched)
+        {
+            const string &DC = it.second.first;
+            const string &task = it.second.second;
+            graph->slots[DC].second.insert(task);
+            graph->addDemand(graph->usage[DC], task);
+            running[task] = make_pair(DC, it.first);
+        }
+        out.type(service::ASSIGN);
+        out.real(scheduler.nextWakeup());
+        out.varint(sched.size());
+        for (const auto &it : sched)
+        {
+            out.real(it.first);
+            out.name(it.second.first);
+            out.name(it.second.second);
+        }
+    }
+
+    bool known(const string &DC, service::Writer &out)
+    {
+        if (graph->slots.find(DC) != graph->slots.end())
+            return true;
+        out.type(service::ERROR);
+        out.text("No Such DC: " + DC);
+        return false;
+    }
+
+    // task can become ready, e.g. not a retry of a running one
+    //  submitted are tasks of this frame
+    bool fresh(const string &task, const unordered_set<string> &submitted,
+               service::Writer &out)
+    {
+        string error;
+        if (!graph->workload->run_time.count(task))
+            error = "No Such Task: ";
+        else if (running.count(task))
+            error = "Task Already Running: ";
+        else if (graph->output_loc.count(task))
+            error = "Task Already Finished: ";
+        else if (scheduler.isReady(task) || submitted.count(task))
+            error = "Task Already Submitted: ";
+        if (error.empty())
+            return true;
+        out.type(service::ERROR);
+        out.text(error + task);
+        return false;
+    }
+
+    // no fewer slots than running tasks
+    bool validSlots(const string &DC, uint64_t slots, service::Writer &out)
+    {
+        if (slots <= INT_MAX && slots >= graph->slots[DC].second.size())
+            return true;
+        out.type(service::ERROR);
+        out.text("Invalid Slots: " + DC + " " + std::to_string(slots));
+        return false;
+    }
+
+    // -1 if link is down, else finite and positive
+    bool validBandwidth(double bandwidth, service::Writer &out)
+    {
+        if (bandwidth == -1 || (std::isfinite(bandwidth) && bandwidth > 0))
+            return true;
+        out.type(service::ERROR);
+        out.text("Invalid Bandwidth: " + std::to_string(bandwidth));
+        return false;
+    }
+
+    // answer a frame, false if connection should be closed
+    //  SUBMITs of a frame are merged, SCHEDULE runs once at its end
+    bool handle(service::Reader &in, uint64_t count,
+                service::Writer &out, bool &shutdown)
+    {
+        // in order sent, so ready set is the same as the client's
+        vector<string> submitted;
+        unordered_set<string> submitted_set;
+        bool sched = false;
+        double time = 0;
+        for (uint64_t i = 0; i < count && in.ok(); ++i)
+        {
+            switch (in.byte())
+            {
+            case service::SUBMIT:
+                for (uint64_t n = in.varint(); n && in.ok(); --n)
+                {
+                    string task = in.name();
+                    if (in.ok() && fresh(task, submitted_set, out))
+                    {
+                        submitted.push_back(task);
+                        submitted_set.insert(task);
+                    }
+                }
+                break;
+            case service::COMPLETE:
+                for (uint64_t n = in.varint(); n && in.ok(); --n)
+                {
+                    string task = in.name();
+                    double t = in.real();
+                    if (in.ok())
+                        complete(task, t, out);
+                }
+                break;
+            case service::SCHEDULE:
+                sched = true;
+                time = in.real();
+                break;
+            case service::SLOTS:
+            {
+                string DC = in.name();
+                uint64_t slots = in.varint();
+                if (in.ok() && known(DC, out) &&
+                    validSlots(DC, slots, out))
+                    graph->slots[DC].first = slots;
+                break;
+            }
+            case service::BANDWIDTH:
+            {
+                string u = in.name(), v = in.name();
+                double bandwidth = in.real();
+                if (in.ok() && known(u, out) && known(v, out) &&
+                    validBandwidth(bandwidth, out))
+                    scheduler.updateLinks(
+                        set_bandwidth(graph, u, v, bandwidth));
+                break;
+            }
+            case service::SHUTDOWN:
+                shutdown = true;
+                break;
+            default:
+                printWarning("Unknown Message, Closing Connection");
+                return false;
+            }
+        }
+        if (!in.ok())
+        {
+            printWarning("Broken Frame, Closing Connection");
+            return false;
+        }
+        scheduler.sumbitTasks(submitted);
+        if (sched)
+            schedule(time, out);
+        return true;
+    }
+
+public:
+    // frames and bytes served
+    long long frames = 0;
+    long long bytes_in = 0, bytes_out = 0;
+
+    // graph from init_data(), scheduler of settings
+    void init(shared_ptr<Graph> graph, const Scheduler &settings)
+    {
+        if (settings.sched_type == Scheduler::BEST_OF_K ||
+            settings.sched_type == Scheduler::MCTS_SEARCH)
+            printError("Policy Needs Simulator, Not Supported by Daemon");
+        this->graph = graph;
+        scheduler = settings;
+        scheduler.initGraph(graph);
+    }
+
+    // bind socket at path, removing a stale one
+    void open(const string &path)
+    {
+        this->path = path;
+        sockaddr_un addr = service::address(path);
+        ::unlink(path.c_str());
+        listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd < 0 ||
+            ::bind(listen_fd, (sockaddr *)&addr, sizeof(addr)) < 0 ||
+            ::listen(listen_fd, 4) < 0)
+            printError("Can't Listen on " + path);
+    }
+
+    // serve clients one by one until SHUTDOWN
+    //  a client has its own name ids
+    void serve()
+    {
+        bool shutdown = false;
+        while (!shutdown)
+        {
+            int fd = ::accept(listen_fd, nullptr, nullptr);
+            if (fd < 0)
+                continue;
+            service::Reader in;
+            service::Writer out;
+            string body;
+            while (!shutdown && service::readFrame(fd, body))
+            {
+                bytes_in += 4 + body.size();
+                uint64_t count = in.load(std::move(body));
+                if (!handle(in, count, out, shutdown))
+                    break;
+                string frame = out.frame();
+                bytes_out += frame.size();
+                frames++;
+                if (!service::writeAll(fd, frame))
+                    break;
+            }
+            ::close(fd);
+        }
+        ::close(listen_fd);
+        ::unlink(path.c_str());
+    }
+};
+
+// batched calls to SchedulerService
+//  calls are sent with next schedule() or flush()
+class SchedulerClient
+{
+private:
+    typedef pair<double, pair<string, string>> Arrange;
+
+    int fd = -1;
+    service::Writer out;
+    service::Reader in;
+
+    // send batch and read answer
+    //  ASSIGN of answer is put in assigned
+    void call(vector<Arrange> *assigned)
+    {
+        string frame = out.frame();
+        bytes_out += frame.size();
+        string body;
+        if (!service::writeAll(fd, frame) ||
+            !service::readFrame(fd, body))
+            printError("Scheduler Daemon Closed Connection");
+        bytes_in += 4 + body.size();
+        uint64_t count = in.load(std::move(body));
+        for (uint64_t i = 0; i < count && in.ok(); ++i)
+        {
+            uint8_t t = in.byte();
+            if (t == service::ERROR)
+                printWarning("Daemon: " + in.text());
+            else if (t == service::ASSIGN && assigned)
+            {
+                wakeup = in.real();
+                for (uint64_t n = in.varint(); n && in.ok(); --n)
+                {
+                    double transfer = in.real();
+                    string DC = in.name();
+                    string task = in.name();
+                    assigned->emplace_back(transfer, make_pair(DC, task));
+                }
+            }
+            else
+                printError("Unexpected Answer from Daemon");
+        }
+        if (!in.ok())
+            printError("Broken Frame from Daemon");
+    }
+
+public:
+    // time to schedule again, from last ASSIGN
+    double wakeup = std::numeric_limits<double>::max();
+    long long bytes_in = 0, bytes_out = 0;
+
+    // false if no daemon listens on path
+    bool connect(const string &path)
+    {
+        sockaddr_un addr = service::address(path);
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 &&
+            ::connect(fd, (sockaddr *)&addr, sizeof(addr)) == 0)
+            return true;
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    ~SchedulerClient()
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    void submit(const unordered_set<string> &tasks)
+    {
+        if (tasks.empty())
+            return;
+        out.type(service::SUBMIT);
+        out.varint(tasks.size());
+        for (const auto &task : tasks)
+            out.name(task);
+    }
+
+    // e.g. {{"tA1",4.5}}
+    //  tA1 finished at 4.5s
+    void complete(const vector<pair<string, double>> &finished)
+    {
+        if (finished.empty())
+            return;
+        out.type(service::COMPLETE);
+        out.varint(finished.size());
+        for (const auto &it : finished)
+        {
+            out.name(it.first);
+            out.real(it.second);
+        }
+    }
+
+    void setSlots(const string &DC, int slots)
+    {
+        out.type(service::SLOTS);
+        out.name(DC);
+        out.varint(slots);
+    }
+
+    void setBandwidth(const string &u, const string &v, double bandwidth)
+    {
+        out.type(service::BANDWIDTH);
+        out.name(u);
+        out.name(v);
+        out.real(bandwidth);
+    }
+
+    // send batched calls with a SCHEDULE at time
+    // e.g. {{4,{"DC1","tA1"}}}
+    //  assign tA1 to DC1, takes 4s to transfer data
+    vector<Arrange> schedule(double time)
+    {
+        out.type(service::SCHEDULE);
+        out.real(time);
+        vector<Arrange> ret;
+        call(&ret);
+        return ret;
+    }
+
+    // send batched calls without scheduling
+    void flush()
+    {
+        if (!out.empty())
+            call(nullptr);
+    }
+
+    void shutdown()
+    {
+        out.type(service::SHUTDOWN);
+        call(nullptr);
+    }
+};
+
+#endif
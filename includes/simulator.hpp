@@ -2,6 +2,7 @@
 #define __SIMULATOR_HPP__
 
 #include "common.hpp"
+#include "job_stream.hpp"
 
 class Simulator
 {
@@ -12,21 +13,140 @@ private:
     // current time of simulator
     double current_time;
 
-    // finish time and name
+    // finish time and name of running copy
+    //  a copy is the task itself or its backup, see backupOf()
     // e.g. {4.5, "tA1"}
+    // note: cancelled copies stay in Q until popped
     typedef pair<double, string> Task;
     priority_queue<Task, vector<Task>, std::greater<Task>> Q;
 
-    // location of task
+    // location of running copy
     // e.g. locates["tA1"]="DC1"
     unordered_map<string, string> locates;
 
+    // transfer time of running copy
+    // e.g. transfers["tA1"]=4
+    unordered_map<string, double> transfers;
+
+    // start and finish time of running copy
+    // e.g. spans["tA1"]={2,8.5}
+    unordered_map<string, pair<double, double>> spans;
+
+    // finished tasks of unfinished jobs
+    //  used by getLagging()
+    unordered_map<string, int> job_done;
+
+    // runtime noise, see initNoise()
+    uint64_t noise_seed = 0;
+    uint64_t noise_replication = 0;
+
+    // jobs arriving in future
+    //  empty if all jobs are loaded at 0
+    shared_ptr<JobStream> stream;
+
+    // bandwidth changes in future, see addLinkEvent()
+    // e.g. {12.5,{{"DC1","DC2"},50}}
+    //  bandwidth of DC1->DC2 becomes 50 at 12.5s
+    typedef pair<double, pair<pair<string, string>, double>> LinkEvent;
+    priority_queue<LinkEvent, vector<LinkEvent>,
+                   std::greater<LinkEvent>>
+        link_events;
+
+private:
+    static string backupOf(const string &task)
+    {
+        return task + "#backup";
+    }
+
+    static string taskOf(const string &copy)
+    {
+        auto pos = copy.rfind("#backup");
+        return pos == string::npos ? copy : copy.substr(0, pos);
+    }
+
+    // run time of copy with noise
+    //  each copy has its own random stream
+    double drawRunTime(const string &copy)
+    {
+        double run = graph->workload->run_time.at(taskOf(copy));
+        if (runtime_sigma <= 0 && straggler_prob <= 0)
+            return run;
+        Rng gen(noise_seed, "runtime:" + copy, noise_replication);
+        if (runtime_sigma > 0)
+        {
+            // mean 1
+            std::lognormal_distribution<double> dis(
+                -runtime_sigma * runtime_sigma / 2, runtime_sigma);
+            run *= dis(gen);
+        }
+        if (gen.uniform() < straggler_prob)
+            // Pareto with scale straggler_scale
+            run *= straggler_scale /
+                   std::pow(1 - gen.uniform(), 1 / straggler_shape);
+        return run;
+    }
+
+    // free slot and resources of copy at time t
+    void release(const string &copy, double t)
+    {
+        string DC = locates[copy];
+        graph->slots[DC].second.erase(copy);
+        graph->addDemand(graph->usage[DC], taskOf(copy), -1);
+        busy_time += t - spans[copy].first;
+        graph->addBusy(DC, spans[copy].first, t);
+        locates.erase(copy);
+        transfers.erase(copy);
+        spans.erase(copy);
+    }
+
 public:
+    // -----> noise begin
+    // run time is multiplied by lognormal noise with mean 1
+    double runtime_sigma = 0;
+    // a copy straggles with straggler_prob
+    //  and is slowed down by Pareto(straggler_scale, straggler_shape)
+    double straggler_prob = 0;
+    double straggler_scale = 3;
+    double straggler_shape = 2;
+    // <----- noise end
+
+    // -----> speculation begin
+    // backup copies launched
+    int backups = 0;
+    // tasks finished by their backup
+    int backup_wins = 0;
+    // slot seconds of all copies
+    double busy_time = 0;
+    // slot seconds of cancelled copies
+    double wasted_time = 0;
+    // <----- speculation end
+
+    // link events applied
+    int link_updates = 0;
+
+    // -----> prefetch begin
+    // tasks run where their inputs were staged
+    int prefetch_hits = 0;
+    // tasks run elsewhere, their staging is wasted
+    int prefetch_misses = 0;
+    // transfer seconds of hits without prefetch,
+    //  and those overlapped with predecessors
+    double staged_time = 0;
+    double hidden_time = 0;
+    // <----- prefetch end
+
     Simulator()
     {
         current_time = 0;
     }
 
+    // same seed gives same noise of every copy
+    void initNoise(uint64_t seed, uint64_t replication = 0)
+    {
+        noise_seed = seed;
+        noise_replication = replication;
+    }
+
     // whether there are running tasks
     // note: check this before tick time
     bool isEmpty()
@@ -46,6 +166,31 @@ public:
         this->graph = graph;
     }
 
+    // copy of simulator on a fork of graph
+    //  running tasks are kept, future arrivals
+    //  and link events are not
+    Simulator fork(shared_ptr<Graph> fork_graph) const
+    {
+        Simulator ret = *this;
+        ret.graph = fork_graph;
+        ret.stream.reset();
+        // they change the shared workload
+        ret.link_events = decltype(link_events)();
+        return ret;
+    }
+
+    // submit jobs in stream when they arrive
+    void updateStream(shared_ptr<JobStream> stream)
+    {
+        this->stream = stream;
+    }
+
+    // whether there are jobs not arrived
+    bool hasArrival()
+    {
+        return stream && !stream->empty();
+    }
+
     double getTime()
     {
         return current_time;
@@ -57,17 +202,96 @@ public:
         current_time += t;
     }
 
-    // forward time to next completion
-    void forwardTime()
+    // time of next completion, arrival or link event
+    //  max double if there is none
+    double nextTime()
     {
-        if (Q.empty())
+        double ret = std::numeric_limits<double>::max();
+        if (!Q.empty())
+            ret = Q.top().first;
+        if (hasArrival())
+            ret = std::min(ret, stream->nextTime());
+        if (!link_events.empty())
+            ret = std::min(ret, link_events.top().first);
+        return ret;
+    }
+
+    // forward time to next completion, arrival or link event
+    //  but not later than wakeup, e.g. a timer of scheduler
+    void forwardTime(double wakeup = std::numeric_limits<double>::max())
+    {
+        if (Q.empty() && !hasArrival() && link_events.empty() &&
+            wakeup == std::numeric_limits<double>::max())
             printError("Q is Empty!");
-        current_time = Q.top().first;
+        current_time = std::max(current_time,
+                                std::min(nextTime(), wakeup));
+    }
+
+    // bandwidth of link u->v becomes bandwidth at time
+    //  -1 brings it down, a bandwidth brings it up again
+    void addLinkEvent(double time, const string &u, const string &v,
+                      double bandwidth)
+    {
+        link_events.push(make_pair(time,
+                                   make_pair(make_pair(u, v), bandwidth)));
+    }
+
+    // apply link events up to now
+    //  return DC pairs whose widest path changed,
+    //  for Scheduler::updateLinks()
+    // note: running transfers keep their time
+    vector<pair<string, string>> getLinkChanges()
+    {
+        vector<pair<string, string>> changed;
+        static const double eps = 1e-8;
+        while (!link_events.empty() &&
+               link_events.top().first <= current_time + eps)
+        {
+            auto link = link_events.top().second;
+            link_events.pop();
+            auto pairs = set_bandwidth(graph, link.first.first,
+                                       link.first.second, link.second);
+            changed.insert(changed.end(), pairs.begin(), pairs.end());
+            link_updates++;
+        }
+        return changed;
+    }
+
+    // get arrived jobs and add them into graph
+    //  then insert them into DAG
+    vector<JobArrival> getArrived()
+    {
+        vector<JobArrival> arrived;
+        static const double eps = 1e-8;
+        while (hasArrival() &&
+               stream->nextTime() <= current_time + eps)
+        {
+            JobArrival job = stream->pop();
+            add_job(graph, job.job);
+            for (const auto &task : job.job["task"])
+                if (task.find("demand") != task.end())
+                    check_demand(graph, task["name"]);
+            // job without task never finishes
+            if (job.job["task"].empty())
+                graph->job_task.erase(job.job["name"]);
+            Workload &work = *graph->workload;
+            work.arrival[job.job["name"]] = job.arrival;
+            for (const auto &it : job.constraint)
+            {
+                // not kept in workload->constraint
+                //  which is only read by DAG::init()
+                work.prev_nodes[it.second].insert(it.first);
+                work.next_nodes[it.first].insert(it.second);
+            }
+            arrived.push_back(std::move(job));
+        }
+        return arrived;
     }
 
     // get scheduled tasks from scheduler
     // e.g. {{4,{"DC1","tA1"}}}
     //  assign tA1 to DC1, takes 4s to transfer data
+    // a running task gets a backup copy, the first to finish wins
     void updateScheduled(vector<pair<double,
                                      pair<string, string>>>
                              scheduled_tasks)
@@ -76,19 +300,162 @@ public:
         {
             string DC = it.second.first;
             string task = it.second.second;
+            string copy = task;
+            if (locates.find(task) != locates.end())
+            {
+                copy = backupOf(task);
+                if (locates.find(copy) != locates.end())
+                    printError("Task Already Has Backup: " + task);
+                backups++;
+            }
             auto &slot = graph->slots[DC];
             unordered_set<string> &tasks = slot.second;
 
             if (slot.first <= tasks.size())
                 printError("No Available Slots on " + DC);
+            if (!graph->fits(task, DC))
+                printError("No Available Resources on " + DC);
 
-            tasks.insert(task);
-            locates[task] = DC;
+            // static inputs staged since then, what is left
+            double transfer = it.first;
+            auto stage = graph->staged.find(task);
+            if (stage != graph->staged.end())
+            {
+                if (stage->second.first == DC)
+                {
+                    double full = graph->transferTime(task, DC);
+                    transfer = std::min(transfer,
+                                        graph->transferTime(task, DC,
+                                                            current_time));
+                    staged_time += full;
+                    hidden_time += std::max(0.0, full - transfer);
+                    prefetch_hits++;
+                }
+                else
+                    prefetch_misses++;
+                graph->staged.erase(stage);
+            }
+
+            tasks.insert(copy);
+            graph->addDemand(graph->usage[DC], task);
+            locates[copy] = DC;
+            transfers[copy] = transfer;
             double finish_time = current_time;
-            finish_time += it.first;
-            finish_time += graph->run_time[task];
-            Q.push(make_pair(finish_time, task));
+            finish_time += transfer;
+            finish_time += drawRunTime(copy);
+            spans[copy] = make_pair(current_time, finish_time);
+            Q.push(make_pair(finish_time, copy));
+        }
+    }
+
+    // tasks not ready whose predecessors are all finished
+    //  or expected to within window seconds
+    //  expected by run_time, noise is not known yet
+    // tasks already staged are left out
+    // e.g. {"tA3"}
+    //  tA1 finishes in 2s and tA2 is done, tA3 needs both
+    vector<string> getNearlyReady(double window)
+    {
+        const Workload &work = *graph->workload;
+        // expected finish time of running tasks
+        unordered_map<string, double> expect;
+        for (const auto &it : spans)
+        {
+            string task = taskOf(it.first);
+            double t = it.second.first + transfers[it.first] +
+                       work.run_time.at(task);
+            auto iter = expect.find(task);
+            if (iter == expect.end() || t < iter->second)
+                expect[task] = t;
+        }
+        // only tasks after a running one are not ready
+        set<string> candidates;
+        for (const auto &it : expect)
+        {
+            auto next_nodes = work.next_nodes.find(it.first);
+            if (next_nodes == work.next_nodes.end())
+                continue;
+            for (const auto &next : next_nodes->second)
+                if (graph->staged.find(next) == graph->staged.end())
+                    candidates.insert(next);
+        }
+        vector<string> ret;
+        for (const auto &task : candidates)
+        {
+            bool nearly = true;
+            for (const auto &prev : work.prev_nodes.at(task))
+            {
+                if (graph->output_loc.count(prev))
+                    continue;
+                auto iter = expect.find(prev);
+                nearly &= iter != expect.end() &&
+                          iter->second <= current_time + window;
+            }
+            if (nearly)
+                ret.push_back(task);
         }
+        return ret;
+    }
+
+    // start staging static inputs of tasks to DCs
+    //  from Scheduler::getPrefetch()
+    // e.g. {{"tA3","DC2"}}
+    //  resources of tA3 in DC.json are sent to DC2 from now
+    void updatePrefetch(const vector<pair<string, string>> &targets)
+    {
+        for (const auto &it : targets)
+            graph->staged[it.first] = make_pair(it.second, current_time);
+    }
+
+    // running tasks without backup lagging behind their jobs
+    //  progress of a task is the fraction of its time elapsed,
+    //  1 if finished
+    //  lagging if progress < ratio * median progress of its job
+    // e.g. {{"tA1","DC1"}}
+    //  tA1 is lagging on DC1
+    vector<pair<string, string>> getLagging(double ratio)
+    {
+        // e.g. {"A",{0.2,0.9}}
+        unordered_map<string, vector<double>> progress;
+        unordered_map<string, double> own;
+        for (const auto &it : spans)
+        {
+            const string &copy = it.first;
+            if (copy != taskOf(copy))
+                continue;
+            double length = it.second.second - it.second.first;
+            double p = length <= 0
+                           ? 1
+                           : (current_time - it.second.first) / length;
+            progress[graph->workload->which_job.at(copy)].push_back(p);
+            if (locates.find(backupOf(copy)) == locates.end())
+                own[copy] = p;
+        }
+
+        // median progress of jobs with 2 tasks known at least
+        unordered_map<string, double> median;
+        for (auto &it : progress)
+        {
+            auto &p = it.second;
+            auto done = job_done.find(it.first);
+            if (done != job_done.end())
+                p.insert(p.end(), done->second, 1);
+            if (p.size() < 2)
+                continue;
+            std::nth_element(p.begin(), p.begin() + p.size() / 2, p.end());
+            median[it.first] = p[p.size() / 2];
+        }
+
+        vector<pair<string, string>> ret;
+        for (const auto &it : own)
+        {
+            auto iter = median.find(graph->workload->which_job.at(it.first));
+            if (iter != median.end() && it.second < ratio * iter->second)
+                ret.emplace_back(it.first, locates[it.first]);
+        }
+        // same order every run
+        std::sort(ret.begin(), ret.end());
+        return ret;
     }
 
     // get finished tasks and update DAG
@@ -97,25 +464,44 @@ public:
     {
         vector<pair<string, double>> finish_tasks;
         // get finished tasks from Q
+        //  <= as eps is lost at large times, e.g. a transfer
+        //  through a down link takes 1e6 per unit
         static const double eps = 1e-8;
         while (!Q.empty() &&
-               Q.top().first < current_time + eps)
+               Q.top().first <= current_time + eps)
         {
-            string task = Q.top().second;
+            string copy = Q.top().second;
             double finish_time = Q.top().first;
-            graph->slots[locates[task]].second.erase(task);
+            Q.pop();
+            // cancelled
+            if (locates.find(copy) == locates.end())
+                continue;
+            string task = taskOf(copy);
+            string DC = locates[copy];
+            double transfer = transfers[copy];
+            double run = finish_time - spans[copy].first - transfer;
+            // before the job may be retired with its demand
+            release(copy, finish_time);
 
-            // update job finish time
-            string job = graph->which_job[task];
-            auto &tasks = graph->job_task[job];
-            tasks.erase(task);
-            if (tasks.empty())
-                graph->finish_time[job] = finish_time;
+            // cancel the other copy
+            string other = copy == task ? backupOf(task) : task;
+            if (locates.find(other) != locates.end())
+            {
+                wasted_time += finish_time - spans[other].first;
+                release(other, finish_time);
+            }
+            if (copy != task)
+                backup_wins++;
 
-            graph->task_span[task] = make_pair(finish_time - graph->run_time[task],
-                                               graph->run_time[task]);
+            string job = graph->workload->which_job.at(task);
+            // update task span and job finish time
+            graph->finishTask(task, DC, transfer, finish_time, run);
+            auto tasks = graph->job_task.find(job);
+            if (tasks == graph->job_task.end() || tasks->second.empty())
+                job_done.erase(job);
+            else
+                job_done[job]++;
             finish_tasks.emplace_back(make_pair(task, finish_time));
-            Q.pop();
         }
         return finish_tasks;
     }
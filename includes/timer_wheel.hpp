@@ -0,0 +1,130 @@
+#ifndef __TIMER_WHEEL_HPP__
+#define __TIMER_WHEEL_HPP__
+
+#include "common.hpp"
+
+// hashed timing wheel keyed to simulator time
+//  a timer with expire time t is put into bucket floor(t/tick) % size
+//  advance(now) visits buckets of the ticks passed since last call
+// e.g. add("tA1", 3.5) then advance(3.6) returns {"tA1"}
+class TimerWheel
+{
+private:
+    double tick;
+    // {key, expire time}, may hold cancelled timers
+    vector<vector<pair<string, double>>> buckets;
+    // last tick visited by advance()
+    long long current;
+    // active timers
+    unordered_map<string, double> timers;
+    // earliest expire time, recomputed by nextExpire() if stale
+    double earliest = std::numeric_limits<double>::max();
+    bool earliest_stale = false;
+
+    // timers already due go to the current bucket
+    int bucket(double t)
+    {
+        return std::max((long long)(t / tick), current) % buckets.size();
+    }
+
+public:
+    TimerWheel(double tick = 0.01, int size = 1024)
+        : tick(tick), buckets(size), current(0) {}
+
+    void add(const string &key, double expire)
+    {
+        auto iter = timers.find(key);
+        if (iter != timers.end() && iter->second == earliest)
+            earliest_stale = true;
+        timers[key] = expire;
+        buckets[bucket(expire)].emplace_back(key, expire);
+        if (!earliest_stale)
+            earliest = std::min(earliest, expire);
+    }
+
+    void cancel(const string &key)
+    {
+        auto iter = timers.find(key);
+        if (iter == timers.end())
+            return;
+        if (iter->second == earliest)
+            earliest_stale = true;
+        timers.erase(iter);
+    }
+
+    bool contains(const string &key)
+    {
+        return timers.find(key) != timers.end();
+    }
+
+    bool empty()
+    {
+        return timers.empty();
+    }
+
+    // earliest expire time among active timers
+    //  kept by add(), after the earliest one is gone
+    //  buckets are scanned from current, a round at most,
+    //  all timers only if they are all a round ahead
+    double nextExpire()
+    {
+        if (!earliest_stale)
+            return earliest;
+        earliest_stale = false;
+        earliest = std::numeric_limits<double>::max();
+        if (timers.empty())
+            return earliest;
+        for (long long t = current; t < current + (long long)buckets.size(); ++t)
+        {
+            for (const auto &item : buckets[t % buckets.size()])
+            {
+                auto iter = timers.find(item.first);
+                if (iter != timers.end() && iter->second == item.second &&
+                    std::max((long long)(item.second / tick), current) == t)
+                    earliest = std::min(earliest, item.second);
+            }
+            if (earliest != std::numeric_limits<double>::max())
+                return earliest;
+        }
+        for (const auto &it : timers)
+            earliest = std::min(earliest, it.second);
+        return earliest;
+    }
+
+    // timers expired by now, removed from wheel
+    vector<string> advance(double now)
+    {
+        vector<string> expired;
+        long long target = (long long)(now / tick);
+        // one round visits every bucket
+        long long from = std::max(current, target - (long long)buckets.size());
+        for (long long t = from; t <= target; ++t)
+        {
+            auto &items = buckets[t % buckets.size()];
+            for (int i = 0; i < items.size();)
+            {
+                auto iter = timers.find(items[i].first);
+                bool alive = iter != timers.end() &&
+                             iter->second == items[i].second;
+                if (alive && items[i].second > now)
+                {
+                    // expires in a later round
+                    ++i;
+                    continue;
+                }
+                if (alive)
+                {
+                    expired.push_back(items[i].first);
+                    timers.erase(iter);
+                    earliest_stale = true;
+                }
+                items[i] = items.back();
+                items.pop_back();
+            }
+        }
+        current = target;
+        return expired;
+    }
+};
+
+#endif
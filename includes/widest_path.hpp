@@ -0,0 +1,196 @@
+#ifndef __WIDEST_PATH_HPP__
+#define __WIDEST_PATH_HPP__
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// widest paths between DCs
+//  data may be relayed by other DCs, so the slowest link
+//  on a path counts and the best path is the widest one
+// weights are 1/bandwidth, so dis[i][j] is
+//  min over paths i->j (at least one link) of max weight on it
+// e.g. link[0][1]=1/100, link[1][2]=1/50, link[0][2]=1/10
+//  dis[0][2]=1/50 by DC1
+class WidestPaths
+{
+private:
+    // fix columns cols of row i, others are right
+    //  a path to them leaves the right ones at some k,
+    //  so start from max(dis[i][k], link[k][j]) and run
+    //  Dijkstra among cols, O(cols * n)
+    void fixRow(int i, const std::vector<int> &cols,
+                std::vector<std::pair<int, int>> &changed)
+    {
+        int n = names.size();
+        std::vector<char> stale(n, 0);
+        for (int j : cols)
+            stale[j] = 1;
+        std::vector<double> est(cols.size());
+        for (int c = 0; c < cols.size(); ++c)
+        {
+            int j = cols[c];
+            // path of a single link
+            est[c] = link[i][j];
+            for (int k = 0; k < n; ++k)
+                if (!stale[k])
+                    est[c] = std::min(est[c],
+                                      std::max(dis[i][k], link[k][j]));
+        }
+        std::vector<char> done(cols.size(), 0);
+        for (int it = 0; it < cols.size(); ++it)
+        {
+            int x = 0;
+            while (done[x])
+                ++x;
+            for (int c = x + 1; c < cols.size(); ++c)
+                if (!done[c] && est[c] < est[x])
+                    x = c;
+            done[x] = 1;
+            for (int c = 0; c < cols.size(); ++c)
+                if (!done[c])
+                    est[c] = std::min(est[c],
+                                      std::max(est[x],
+                                               link[cols[x]][cols[c]]));
+        }
+        for (int c = 0; c < cols.size(); ++c)
+            if (est[c] != dis[i][cols[c]])
+            {
+                dis[i][cols[c]] = est[c];
+                changed.emplace_back(i, cols[c]);
+            }
+    }
+
+    // widest path u->v without link u->v, O(n^2)
+    double bypass(int u, int v) const
+    {
+        int n = names.size();
+        std::vector<double> d = link[u];
+        d[v] = link_none;
+        std::vector<char> done(n, 0);
+        for (int it = 0; it < n; ++it)
+        {
+            int k = 0;
+            while (done[k])
+                ++k;
+            for (int j = k + 1; j < n; ++j)
+                if (!done[j] && d[j] < d[k])
+                    k = j;
+            done[k] = 1;
+            for (int j = 0; j < n; ++j)
+                if (k != u || j != v)
+                    d[j] = std::min(d[j], std::max(d[k], link[k][j]));
+        }
+        return d[v];
+    }
+
+    // weight of a missing link
+    double link_none = 0;
+
+public:
+    // DC i is names[i]
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> id;
+    // direct links in link.json, and widest paths
+    std::vector<std::vector<double>> link, dis;
+
+    // new DC without links, whose weight is none
+    int add(const std::string &name, double none)
+    {
+        link_none = none;
+        auto iter = id.find(name);
+        if (iter != id.end())
+            return iter->second;
+        int n = names.size();
+        names.push_back(name);
+        id[name] = n;
+        for (auto &it : link)
+            it.push_back(none);
+        link.push_back(std::vector<double>(n + 1, none));
+        return n;
+    }
+
+    // all pairs, O(n^3) with Floyd
+    void build()
+    {
+        int n = names.size();
+        dis = link;
+        for (int k = 0; k < n; ++k)
+            for (int i = 0; i < n; ++i)
+            {
+                double d_ik = dis[i][k];
+                for (int j = 0; j < n; ++j)
+                    // #### modify this to change bandwidth
+                    // dis[i][j] = std::min(dis[i][j], d_ik + dis[k][j]);
+                    dis[i][j] = std::min(dis[i][j],
+                                         std::max(d_ik, dis[k][j]));
+            }
+    }
+
+    // weight of link u->v becomes w
+    //  return pairs whose widest path changed
+    // wider: relax every pair by the link, O(n^2)
+    // narrower: only pairs whose best path may use the link,
+    //  those with dis[i][j] == max(dis[i][u], old, dis[v][j]),
+    //  and narrower than w and than paths around the link,
+    //  are recomputed, O(n) each, see fixRow()
+    std::vector<std::pair<int, int>> setLink(int u, int v, double w)
+    {
+        std::vector<std::pair<int, int>> changed;
+        double old = link[u][v];
+        link[u][v] = w;
+        if (w == old)
+            return changed;
+        int n = names.size();
+        // widest path to u and from v, empty path is 0
+        auto pre = [&](int i)
+        { return i == u ? 0 : dis[i][u]; };
+        auto post = [&](int j)
+        { return j == v ? 0 : dis[v][j]; };
+
+        if (w < old)
+        {
+            // pre and post never use the link themselves
+            std::vector<double> to_u(n), from_v(n);
+            for (int i = 0; i < n; ++i)
+                to_u[i] = pre(i), from_v[i] = post(i);
+            for (int i = 0; i < n; ++i)
+            {
+                double head = std::max(to_u[i], w);
+                for (int j = 0; j < n; ++j)
+                {
+                    double d = std::max(head, from_v[j]);
+                    if (d < dis[i][j])
+                    {
+                        dis[i][j] = d;
+                        changed.emplace_back(i, j);
+                    }
+                }
+            }
+            return changed;
+        }
+
+        // paths around the link are as wide as bypass()
+        //  so pairs not wider than that keep their value
+        double limit = std::min(w, bypass(u, v));
+        // stale pairs of each row, by old dis
+        std::vector<std::vector<int>> stale(n);
+        for (int i = 0; i < n; ++i)
+        {
+            double head = std::max(pre(i), old);
+            for (int j = 0; j < n; ++j)
+                if (dis[i][j] < limit &&
+                    dis[i][j] == std::max(head, post(j)))
+                    stale[i].push_back(j);
+        }
+        // a row only reads itself and links
+        for (int i = 0; i < n; ++i)
+            if (!stale[i].empty())
+                fixRow(i, stale[i], changed);
+        return changed;
+    }
+};
+
+#endif
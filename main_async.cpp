@@ -0,0 +1,179 @@
+#include <chrono>
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+#include "includes/pipeline.hpp"
+
+struct Result
+{
+    double makespan;
+    double average;
+    // wall time per round
+    double latency;
+    double max_latency;
+    int rounds;
+    int conflicts;
+};
+
+void init_scheduler(Scheduler &scheduler, Scheduler::SchedType sched_type)
+{
+    scheduler.sched_type = sched_type;
+    scheduler.neck_type = Scheduler::SAME_NEXT;
+}
+
+void update(Simulator &sim, DAG &dag)
+{
+    auto finished = sim.getFinished();
+    dag.updateDAG(finished);
+}
+
+// event driven, decisions take no simulator time
+Result run_sync(Scheduler::SchedType sched_type)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler;
+    init_scheduler(scheduler, sched_type);
+    Simulator sim;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+
+    double latency = 0, max_latency = 0;
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        auto start = std::chrono::steady_clock::now();
+        auto sched = scheduler.getScheduled();
+        double wall = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+        latency += wall;
+        max_latency = std::max(max_latency, wall);
+        sim.updateScheduled(sched);
+
+        sim.forwardTime();
+        update(sim, dag);
+    }
+    graph->printStatistics("");
+    print_bound(graph, bound, sim.getTime());
+    int rounds = graph->stats.rounds;
+    return {sim.getTime(), graph->stats.mean,
+            latency / std::max(rounds, 1), max_latency, rounds, 0};
+}
+
+// rounds run on a worker thread while simulator goes on
+//  decisions are applied latency_scale * solve time later
+Result run_async(Scheduler::SchedType sched_type, double latency_scale)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler;
+    init_scheduler(scheduler, sched_type);
+    Simulator sim;
+    AsyncScheduler async;
+    async.latency_scale = latency_scale;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+    async.init(&scheduler, graph);
+
+    // whether state changed since last round started
+    //  a round on the same state gives nothing new
+    bool dirty = true;
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        if (!async.busy() && dirty && scheduler.taskSize() > 0)
+        {
+            async.start(sim.getTime());
+            dirty = false;
+        }
+        if (!async.busy())
+        {
+            sim.forwardTime();
+            update(sim, dag);
+            dirty = true;
+            continue;
+        }
+
+        // sleep until the round finishes or next event is due
+        async.waitUntil(sim.nextTime());
+        bool done = async.ready();
+        double apply_time = async.applyTime();
+        if (done && sim.nextTime() > apply_time)
+        {
+            // state is as the round planned
+            //  unless events came meanwhile, see below
+            sim.forwardTime(apply_time);
+            sim.updateScheduled(async.finish());
+        }
+        else if (sim.nextTime() <= apply_time)
+        {
+            // events before decisions arrive
+            sim.forwardTime(apply_time);
+            update(sim, dag);
+            dirty = true;
+        }
+    }
+    graph->printStatistics("async.log");
+    print_bound(graph, bound, sim.getTime());
+    return {sim.getTime(), graph->stats.mean,
+            async.latency / std::max(async.rounds, 1), async.max_latency,
+            async.rounds, async.conflicts};
+}
+
+void print_result(const string &name, const Result &res)
+{
+    // latency in ms
+    std::cout << name << ": " << res.makespan << ' '
+              << res.average << ' '
+              << res.latency * 1000 << "ms "
+              << "MAX: " << res.max_latency * 1000 << "ms "
+              << "ROUNDS: " << res.rounds << ' '
+              << "CONFLICTS: " << res.conflicts << '\n';
+}
+
+int main()
+{
+    // read settings from file
+    // e.g. "NETWORK_NECK 100"
+    //  solve NETWORK_NECK rounds, a wall second of solving
+    //  is 100 seconds in simulator
+    const unordered_map<string, Scheduler::SchedType> policies = {
+        {"GREEDY", Scheduler::GREEDY},
+        {"K_GREEDY", Scheduler::K_GREEDY},
+        {"RANDOM", Scheduler::RANDOM},
+        {"NETWORK_SUM", Scheduler::NETWORK_SUM},
+        {"NETWORK_NECK", Scheduler::NETWORK_NECK}};
+    string policy = "NETWORK_NECK";
+    double latency_scale = 100;
+    std::ifstream fin;
+    fin.open("async_settings.txt");
+    if (fin.is_open())
+        fin >> policy >> latency_scale;
+    if (policies.find(policy) == policies.end())
+        printError("Unsupported Async Policy: " + policy);
+
+    std::cout << "SYNC:" << std::endl;
+    Result sync = run_sync(policies.at(policy));
+    std::cout << "ASYNC:" << std::endl;
+    Result async = run_async(policies.at(policy), latency_scale);
+
+    print_result("SYNC", sync);
+    print_result("ASYNC", async);
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include <chrono>
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+
+// e.g. {12.5,{{"DC1","DC2"},50}}
+//  bandwidth of DC1->DC2 becomes 50 at 12.5s
+typedef pair<double, pair<pair<string, string>, double>> LinkEvent;
+
+struct Result
+{
+    double makespan;
+    double average;
+    // wall time of widest path updates
+    double update_time;
+    long long pairs_changed;
+    long long cost_dropped;
+};
+
+// events from link_events.txt if it exists
+// e.g. "12.5 DC1 DC2 -1"
+//  DC1->DC2 is down at 12.5s
+// or events degrading random links
+//  by factor for duration seconds in [0, horizon]
+//  both directions, then back to bandwidth in link.json
+vector<LinkEvent> read_events(int count, double factor, double duration,
+                              uint64_t seed, double horizon)
+{
+    vector<LinkEvent> ret;
+    std::ifstream fin;
+    fin.open("link_events.txt");
+    if (fin.is_open())
+    {
+        double time, bandwidth;
+        string u, v;
+        while (fin >> time >> u >> v >> bandwidth)
+            ret.push_back(make_pair(time,
+                                    make_pair(make_pair(u, v), bandwidth)));
+        return ret;
+    }
+
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_topology(graph);
+    const vector<string> &DCs = graph->workload->paths.names;
+    if (DCs.size() < 2)
+        return ret;
+    Rng gen(seed, "link_events", 0);
+    for (int i = 0; i < count; ++i)
+    {
+        string u = DCs[gen.randInt(0, DCs.size() - 1)];
+        string v = DCs[gen.randInt(0, DCs.size() - 1)];
+        double bandwidth = get_bandwidth(graph, u, v);
+        if (u == v || bandwidth == -1)
+        {
+            // draw again
+            --i;
+            continue;
+        }
+        double start = gen.uniform() * horizon;
+        for (const auto &link : {make_pair(u, v), make_pair(v, u)})
+        {
+            double origin = get_bandwidth(graph, link.first, link.second);
+            double degraded = factor > 0 && origin != -1
+                                  ? origin * factor
+                                  : -1;
+            ret.push_back(make_pair(start, make_pair(link, degraded)));
+            ret.push_back(make_pair(start + duration,
+                                    make_pair(link, origin)));
+        }
+    }
+    return ret;
+}
+
+Result run(Scheduler::SchedType sched_type, const vector<LinkEvent> &events)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds on stable links, events only slow transfers
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler;
+    scheduler.sched_type = sched_type;
+    scheduler.neck_type = Scheduler::SAME_NEXT;
+    Simulator sim;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+    for (const auto &it : events)
+        sim.addLinkEvent(it.first, it.second.first.first,
+                         it.second.first.second, it.second.second);
+
+    double update_time = 0;
+    long long pairs_changed = 0;
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        scheduler.updateTime(sim.getTime());
+        auto sched = scheduler.getScheduled();
+        sim.updateScheduled(sched);
+
+        // wake up at link events too
+        sim.forwardTime(scheduler.nextWakeup());
+        auto start = std::chrono::steady_clock::now();
+        auto changed = sim.getLinkChanges();
+        update_time += std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+        pairs_changed += changed.size();
+        scheduler.updateLinks(changed);
+        dag.updateDAG(sim.getFinished());
+    }
+    graph->printStatistics("");
+    print_bound(graph, bound, sim.getTime());
+    return {sim.getTime(), graph->stats.mean, update_time,
+            pairs_changed, scheduler.cost_dropped};
+}
+
+// wall time of recomputing all widest paths once
+double floyd_time()
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_topology(graph);
+    auto start = std::chrono::steady_clock::now();
+    widest_paths(*graph->workload);
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int main()
+{
+    // read settings from file
+    // e.g. "20 0.1 10 1"
+    //  20 random links get 10% of bandwidth for 10s,
+    //  drawn with seed 1, factor 0 brings them down
+    int count = 20;
+    double factor = 0.1, duration = 10;
+    uint64_t seed = 1;
+    std::ifstream fin;
+    fin.open("bandwidth_settings.txt");
+    if (fin.is_open())
+        fin >> count >> factor >> duration >> seed;
+
+    const vector<pair<string, Scheduler::SchedType>> policies = {
+        {"GREEDY", Scheduler::GREEDY},
+        {"NETWORK_SUM", Scheduler::NETWORK_SUM},
+        {"NETWORK_NECK", Scheduler::NETWORK_NECK},
+        {"DELAY", Scheduler::DELAY}};
+    vector<Result> stable, degraded;
+    for (const auto &policy : policies)
+    {
+        std::cout << policy.first << ":" << std::endl;
+        stable.push_back(run(policy.second, {}));
+    }
+    // events while the slowest policy runs
+    double horizon = 0;
+    for (const auto &it : stable)
+        horizon = std::max(horizon, it.makespan);
+    vector<LinkEvent> events = read_events(count, factor, duration,
+                                           seed, horizon);
+    for (const auto &policy : policies)
+    {
+        std::cout << policy.first << " DEGRADED:" << std::endl;
+        degraded.push_back(run(policy.second, events));
+    }
+
+    // makespan and average, stable then degraded
+    for (int i = 0; i < policies.size(); ++i)
+        std::cout << policies[i].first << ": "
+                  << stable[i].makespan << ' ' << stable[i].average
+                  << " -> "
+                  << degraded[i].makespan << ' ' << degraded[i].average
+                  << " COSTS DROPPED: " << degraded[i].cost_dropped
+                  << '\n';
+    // time per event in ms
+    const Result &res = degraded[0];
+    std::cout << "LINK EVENTS: " << events.size() << ' '
+              << "PAIRS CHANGED: " << res.pairs_changed << ' '
+              << "INCREMENTAL: "
+              << res.update_time / std::max<size_t>(events.size(), 1) * 1000
+              << "ms FLOYD: " << floyd_time() * 1000 << "ms" << std::endl;
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+
+int main()
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler;
+    scheduler.sched_type = Scheduler::BEST_OF_K;
+    Simulator sim;
+
+    // read settings from file
+    // e.g. "4 10"
+    //  4 candidates per round, each rollout simulates 10s
+    std::ifstream fin;
+    fin.open("best_k_settings.txt");
+    if (fin.is_open())
+        fin >> scheduler.best_k >> scheduler.rollout_horizon;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    scheduler.initLookahead(&sim, &dag);
+    // same seed.txt gives same run
+    auto seed = readSeed();
+    scheduler.initSeed(seed.first, seed.second);
+    sim.updateGraph(graph);
+    // sim.printStatus();
+    int task_cnt = 0;
+    // wall time spent in scheduler
+    double sched_time = 0;
+    while (!dag.if_finished())
+    {
+
+        scheduler.sumbitTasks(dag.getSubmit());
+        auto start = std::chrono::steady_clock::now();
+        auto sched = scheduler.getScheduled();
+        sched_time += std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+        sim.updateScheduled(sched);
+
+        sim.forwardTime();
+        auto finished = sim.getFinished();
+
+        task_cnt += finished.size();
+        dag.updateDAG(finished);
+    }
+    std::cout << "BEST_OF_K: " << sim.getTime() << "\n";
+    std::cout << "K: " << scheduler.best_k << ' '
+              << "HORIZON: " << scheduler.rollout_horizon << ' '
+              << "SCHED TIME: " << sched_time << std::endl;
+    graph->printStatistics("best_k.log");
+    print_bound(graph, bound, sim.getTime());
+    graph->printFinishTime("best_k.txt");
+    graph->printData("best_k_data.txt");
+
+    std::cout << std::endl;
+    return 0;
+}
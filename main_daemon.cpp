@@ -0,0 +1,27 @@
+#include "includes/common.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/service.hpp"
+
+int main()
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    string path = "/tmp/scheduler.sock";
+    Scheduler settings;
+    read_service_settings(path, settings);
+
+    SchedulerService service;
+    service.init(graph, settings);
+    service.open(path);
+    std::cout << "LISTENING: " << path << std::endl;
+    service.serve();
+
+    std::cout << "FRAMES: " << service.frames << ' '
+              << "IN: " << service.bytes_in << "B "
+              << "OUT: " << service.bytes_out << "B" << std::endl;
+    graph->printStatistics("daemon.log");
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+
+int main()
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler;
+    scheduler.sched_type = Scheduler::DELAY;
+    Simulator sim;
+
+    // read settings from file
+    // e.g. "1 0.1"
+    //  wait 1s at most for DCs within 110% of best transfer time
+    std::ifstream fin;
+    fin.open("delay_settings.txt");
+    if (fin.is_open())
+        fin >> scheduler.delay_wait >> scheduler.delay_ratio;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+    // sim.printStatus();
+    int task_cnt = 0;
+    while (!dag.if_finished())
+    {
+
+        scheduler.sumbitTasks(dag.getSubmit());
+        scheduler.updateTime(sim.getTime());
+        auto sched = scheduler.getScheduled();
+        sim.updateScheduled(sched);
+
+        // wake up when a waiting task times out
+        sim.forwardTime(scheduler.nextWakeup());
+        auto finished = sim.getFinished();
+
+        task_cnt += finished.size();
+        dag.updateDAG(finished);
+    }
+    std::cout << "DELAY: " << sim.getTime() << "\n";
+    std::cout << "WAITS: " << scheduler.delay_waits << ' '
+              << "LOCAL AFTER WAIT: " << scheduler.delay_hits << std::endl;
+    graph->printStatistics("delay.log");
+    print_bound(graph, bound, sim.getTime());
+    graph->printFinishTime("delay.txt");
+    graph->printData("delay_data.txt");
+
+    std::cout << std::endl;
+    return 0;
+}
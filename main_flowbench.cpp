@@ -0,0 +1,121 @@
+#include <chrono>
+#include "includes/common.hpp"
+#include "includes/network_neck.hpp"
+
+typedef pair<double, pair<string, string>> Assign;
+
+// a ready set of one scheduling round
+struct ReadySet
+{
+    int task_num;
+    vector<vector<string>> task_group;
+    vector<pair<string, int>> cap_info;
+    vector<Assign> assign_info;
+};
+
+// tasks in groups of group_size, every task can go to every DC
+//  slots are enough for all tasks
+ReadySet generate(int tasks, int DCs, int group_size,
+                  uint64_t seed, int round)
+{
+    Rng gen(seed, "flowbench", round);
+    ReadySet ret;
+    ret.task_num = tasks;
+
+    int slots = 0, mx = std::max(1, 2 * tasks / DCs);
+    for (int i = 0; i < DCs; ++i)
+    {
+        ret.cap_info.emplace_back("DC" + std::to_string(i + 1),
+                                  gen.randInt(1, mx));
+        slots += ret.cap_info.back().second;
+    }
+    for (int i = 0; slots < tasks; i = (i + 1) % DCs, ++slots)
+        ret.cap_info[i].second++;
+
+    for (int i = 0; i < tasks; ++i)
+    {
+        string task = "t" + std::to_string(i);
+        if (i % group_size == 0)
+            ret.task_group.push_back({});
+        ret.task_group.back().push_back(task);
+        // skewed, most DCs are fast
+        for (const auto &it : ret.cap_info)
+            ret.assign_info.emplace_back(
+                1 + 100 * std::pow(gen.uniform(), 3),
+                make_pair(it.first, task));
+    }
+    return ret;
+}
+
+struct Result
+{
+    double time;
+    // worst transfer time of assigned tasks
+    double worst;
+    int assigned;
+};
+
+Result run(const ReadySet &ready, NetworkNeck::FlowType flow_type)
+{
+    NetworkNeck net_neck;
+    net_neck.sched_type = NetworkNeck::FAIR;
+    net_neck.flow_type = flow_type;
+    auto start = std::chrono::steady_clock::now();
+    net_neck.initNetwork(ready.task_num, ready.task_group,
+                         ready.cap_info, ready.assign_info);
+    auto assigned = net_neck.getSched();
+    double time = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+    double worst = 0;
+    for (const auto &it : assigned)
+        worst = std::max(worst, it.first);
+    return {time, worst, (int)assigned.size()};
+}
+
+int main()
+{
+    // read settings from file
+    // e.g. "200 20 4 5 1"
+    //  200 tasks in groups of 4 on 20 DCs,
+    //  5 rounds with seed 1
+    int tasks = 200, DCs = 20, group_size = 4, rounds = 5;
+    uint64_t seed = 1;
+    std::ifstream fin;
+    fin.open("flowbench_settings.txt");
+    if (fin.is_open())
+        fin >> tasks >> DCs >> group_size >> rounds >> seed;
+
+    const vector<pair<string, NetworkNeck::FlowType>> backends = {
+        {"DINIC", NetworkNeck::DINIC},
+        {"PUSH_RELABEL", NetworkNeck::PUSH_RELABEL},
+        {"MATCHING", NetworkNeck::MATCHING}};
+    vector<double> total(backends.size(), 0);
+    for (int r = 0; r < rounds; ++r)
+    {
+        ReadySet ready = generate(tasks, DCs, group_size, seed, r);
+        Result base;
+        for (int i = 0; i < backends.size(); ++i)
+        {
+            Result res = run(ready, backends[i].second);
+            total[i] += res.time;
+            if (i == 0)
+                base = res;
+            // the first bottleneck is the same whatever max flow is
+            else if (res.assigned != base.assigned ||
+                     std::fabs(res.worst - base.worst) > 1e-6)
+                printWarning("Round " + std::to_string(r) + " " +
+                             backends[i].first + " Differs: " +
+                             std::to_string(base.worst) + " " +
+                             std::to_string(res.worst));
+        }
+    }
+
+    // time per round in ms, speedup over DINIC
+    for (int i = 0; i < backends.size(); ++i)
+        std::cout << backends[i].first << ": "
+                  << total[i] / rounds * 1000 << "ms "
+                  << "SPEEDUP: " << total[0] / total[i] << '\n';
+    std::cout << std::endl;
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "includes/common.hpp"
+#include "includes/analysis.hpp"
 #include "includes/DAG.hpp"
 #include "includes/scheduler.hpp"
 #include "includes/simulator.hpp"
@@ -8,6 +9,8 @@ int main()
     shared_ptr<Graph> graph;
     graph = make_shared<Graph>();
     init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
     DAG dag;
     Scheduler scheduler;
     scheduler.sched_type = scheduler.GREEDY;
@@ -16,6 +19,10 @@ int main()
     dag.init(graph);
     scheduler.initGraph(graph);
     sim.updateGraph(graph);
+    // stream tasks' span into tasks.csv
+    graph->sink = make_shared<OutputSink>();
+    if (!graph->sink->open("tasks.csv", ""))
+        printError("Can't Open tasks.csv");
     // sim.printStatus();
     int task_cnt = 0;
 
@@ -78,11 +85,12 @@ int main()
     std::cout << "TIME: " << TIME_cnt << ' '
               << "TASK: " << TASK_cnt << std::endl;
     graph->printStatistics("greedy.log");
+    print_bound(graph, bound, sim.getTime());
     graph->printFinishTime("greedy.txt");
     // graph->printFinishTime();
     graph->printData("greedy_data.txt");
 
-    graph->printTasks();
+    graph->sink->close();
 
     std::cout << std::endl;
     return 0;
@@ -0,0 +1,90 @@
+#include <chrono>
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+
+struct Result
+{
+    double makespan;
+    double average;
+    // wall time spent in scheduler
+    double sched_time;
+    int rounds;
+};
+
+// event driven simulation with scheduler of sched_type
+Result run(Scheduler::SchedType sched_type,
+           const Scheduler &settings,
+           string log_name)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler = settings;
+    scheduler.sched_type = sched_type;
+    Simulator sim;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+
+    double sched_time = 0;
+    int rounds = 0;
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        auto start = std::chrono::steady_clock::now();
+        auto sched = scheduler.getScheduled();
+        sched_time += std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+        rounds++;
+        sim.updateScheduled(sched);
+
+        sim.forwardTime();
+        auto finished = sim.getFinished();
+        dag.updateDAG(finished);
+    }
+    graph->printStatistics(log_name);
+    print_bound(graph, bound, sim.getTime());
+    return {sim.getTime(), graph->stats.mean, sched_time, rounds};
+}
+
+int main()
+{
+    Scheduler settings;
+    // read settings from file
+    // e.g. "10 4 64"
+    //  10 regions, 4 threads
+    //  sqrt(DCs) regions if 0
+    //  rounds placing fewer than 64 tasks use one thread,
+    //  64 if not given
+    std::ifstream fin;
+    fin.open("hierarchy_settings.txt");
+    if (fin.is_open())
+        fin >> settings.region_count >> settings.hierarchy_threads >>
+            settings.hierarchy_inline;
+
+    std::cout << "GREEDY:" << std::endl;
+    Result greedy = run(Scheduler::GREEDY, settings, "");
+    std::cout << "HIERARCHY:" << std::endl;
+    Result hierarchy = run(Scheduler::HIERARCHY, settings, "hierarchy.log");
+
+    // decision latency per round in ms
+    std::cout << "GREEDY: " << greedy.makespan << ' '
+              << greedy.average << ' '
+              << greedy.sched_time / std::max(greedy.rounds, 1) * 1000
+              << "ms\n"
+              << "HIERARCHY: " << hierarchy.makespan << ' '
+              << hierarchy.average << ' '
+              << hierarchy.sched_time / std::max(hierarchy.rounds, 1) * 1000
+              << "ms" << std::endl;
+
+    std::cout << std::endl;
+    return 0;
+}
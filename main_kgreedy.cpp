@@ -1,4 +1,5 @@
 #include "includes/common.hpp"
+#include "includes/analysis.hpp"
 #include "includes/DAG.hpp"
 #include "includes/scheduler.hpp"
 #include "includes/simulator.hpp"
@@ -8,6 +9,8 @@ int main()
     shared_ptr<Graph> graph;
     graph = make_shared<Graph>();
     init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
     DAG dag;
     Scheduler scheduler;
     scheduler.sched_type = scheduler.K_GREEDY;
@@ -15,7 +18,14 @@ int main()
 
     dag.init(graph);
     scheduler.initGraph(graph);
+    // same seed.txt gives same run
+    auto seed = readSeed();
+    scheduler.initSeed(seed.first, seed.second);
     sim.updateGraph(graph);
+    // stream tasks' span into tasks.csv
+    graph->sink = make_shared<OutputSink>();
+    if (!graph->sink->open("tasks.csv", ""))
+        printError("Can't Open tasks.csv");
     // sim.printStatus();
     int task_cnt = 0;
     while (!dag.if_finished())
@@ -38,11 +48,14 @@ int main()
         dag.updateDAG(finished);
     }
     std::cout << "K_GREEDY: " << sim.getTime() << "\n";
+    std::cout << "SEED: " << seed.first << ' '
+              << seed.second << std::endl;
     graph->printStatistics("k_greedy.log");
+    print_bound(graph, bound, sim.getTime());
     graph->printFinishTime("k_greedy.txt");
     graph->printData("k_greedy_data.txt");
 
-    graph->printTasks();
+    graph->sink->close();
 
     std::cout << std::endl;
     return 0;
@@ -0,0 +1,98 @@
+#include <chrono>
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+
+struct Result
+{
+    double makespan;
+    double average;
+    // wall time spent in scheduler
+    double sched_time;
+};
+
+// event driven simulation with scheduler of sched_type
+Result run(Scheduler::SchedType sched_type,
+           const Scheduler &settings,
+           string log_name)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler = settings;
+    scheduler.sched_type = sched_type;
+    Simulator sim;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    scheduler.initLookahead(&sim, &dag);
+    sim.updateGraph(graph);
+
+    double sched_time = 0;
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        auto start = std::chrono::steady_clock::now();
+        auto sched = scheduler.getScheduled();
+        sched_time += std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+        sim.updateScheduled(sched);
+
+        sim.forwardTime();
+        auto finished = sim.getFinished();
+        dag.updateDAG(finished);
+    }
+    graph->printStatistics(log_name);
+    print_bound(graph, bound, sim.getTime());
+    if (sched_type == Scheduler::MCTS_SEARCH)
+        std::cout << "ITERATIONS: " << scheduler.mcts_iterations << '\n';
+    return {sim.getTime(), graph->stats.mean, sched_time};
+}
+
+int main()
+{
+    Scheduler settings;
+    // read settings from file
+    // e.g. "4 3 0.05 4 10"
+    //  4 candidates per round, look 3 rounds ahead,
+    //  search 0.05s per round with 4 threads,
+    //  each rollout simulates 10s
+    std::ifstream fin;
+    fin.open("mcts_settings.txt");
+    if (fin.is_open())
+        fin >> settings.mcts_actions >> settings.mcts_depth >>
+            settings.mcts_budget >> settings.mcts_threads >>
+            settings.rollout_horizon;
+    // same seed.txt gives same run
+    auto seed = readSeed();
+    settings.initSeed(seed.first, seed.second);
+
+    std::cout << "GREEDY:" << std::endl;
+    Result greedy = run(Scheduler::GREEDY, settings, "");
+    std::cout << "MCTS:" << std::endl;
+    Result mcts = run(Scheduler::MCTS_SEARCH, settings, "mcts.log");
+
+    std::cout << "GREEDY: " << greedy.makespan << ' '
+              << greedy.average << ' ' << greedy.sched_time << '\n'
+              << "MCTS: " << mcts.makespan << ' '
+              << mcts.average << ' ' << mcts.sched_time << '\n';
+    // improvement per second spent in scheduler
+    double extra = std::max(mcts.sched_time - greedy.sched_time, 1e-9);
+    std::cout << "MAKESPAN IMPROVE: "
+              << (greedy.makespan - mcts.makespan) / greedy.makespan * 100
+              << "% " << (greedy.makespan - mcts.makespan) / extra
+              << "s/s\n"
+              << "AVERAGE IMPROVE: "
+              << (greedy.average - mcts.average) / greedy.average * 100
+              << "% " << (greedy.average - mcts.average) / extra
+              << "s/s" << std::endl;
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <chrono>
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+
+struct Result
+{
+    double makespan;
+    double average;
+};
+
+Result run(Scheduler::SchedType sched_type, bool multipath, int threads)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    if (multipath)
+        use_multipath(graph, true, threads);
+    // lower bounds of this transfer model
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler;
+    scheduler.sched_type = sched_type;
+    scheduler.neck_type = Scheduler::SAME_NEXT;
+    Simulator sim;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        scheduler.updateTime(sim.getTime());
+        auto sched = scheduler.getScheduled();
+        sim.updateScheduled(sched);
+
+        sim.forwardTime(scheduler.nextWakeup());
+        dag.updateDAG(sim.getFinished());
+    }
+    graph->printStatistics("");
+    print_bound(graph, bound, sim.getTime());
+    return {sim.getTime(), graph->stats.mean};
+}
+
+// wall time of computing all max flows once
+double flow_time(int threads, long long &solved)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_topology(graph);
+    auto start = std::chrono::steady_clock::now();
+    use_multipath(graph, true, threads);
+    solved = graph->workload->flows_solved;
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int main()
+{
+    // read settings from file
+    // e.g. "4"
+    //  max flows are computed by 4 threads, 0 for all cores
+    int threads = 0;
+    std::ifstream fin;
+    fin.open("multipath_settings.txt");
+    if (fin.is_open())
+        fin >> threads;
+
+    const vector<pair<string, Scheduler::SchedType>> policies = {
+        {"GREEDY", Scheduler::GREEDY},
+        {"NETWORK_SUM", Scheduler::NETWORK_SUM},
+        {"NETWORK_NECK", Scheduler::NETWORK_NECK},
+        {"DELAY", Scheduler::DELAY}};
+    vector<Result> single, multi;
+    for (const auto &policy : policies)
+    {
+        std::cout << policy.first << ":" << std::endl;
+        single.push_back(run(policy.second, false, threads));
+        std::cout << policy.first << " MULTIPATH:" << std::endl;
+        multi.push_back(run(policy.second, true, threads));
+    }
+
+    // makespan and average, widest path then max flow
+    for (int i = 0; i < policies.size(); ++i)
+        std::cout << policies[i].first << ": "
+                  << single[i].makespan << ' ' << single[i].average
+                  << " -> "
+                  << multi[i].makespan << ' ' << multi[i].average << '\n';
+    // precomputation in ms, one thread and the given ones
+    long long solved;
+    double serial = flow_time(1, solved);
+    double parallel = flow_time(threads, solved);
+    std::cout << "PAIRS SOLVED: " << solved << ' '
+              << "ONE THREAD: " << serial * 1000 << "ms "
+              << "PARALLEL: " << parallel * 1000 << "ms" << std::endl;
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "includes/common.hpp"
+#include "includes/analysis.hpp"
 #include "includes/DAG.hpp"
 #include "includes/scheduler.hpp"
 #include "includes/simulator.hpp"
@@ -8,6 +9,8 @@ int main()
     shared_ptr<Graph> graph;
     graph = make_shared<Graph>();
     init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
     DAG dag;
     Scheduler scheduler;
     scheduler.sched_type = Scheduler::NETWORK_NECK;
@@ -17,6 +20,10 @@ int main()
     dag.init(graph);
     scheduler.initGraph(graph);
     sim.updateGraph(graph);
+    // stream tasks' span into tasks.csv
+    graph->sink = make_shared<OutputSink>();
+    if (!graph->sink->open("tasks.csv", ""))
+        printError("Can't Open tasks.csv");
     // sim.printStatus();
     int task_cnt = 0;
 
@@ -24,10 +31,23 @@ int main()
     double TIME_THRESHOLD = 0.2;
     double pre_time = 0;
     // read settings from file
+    // e.g. "4 0.2 PUSH_RELABEL"
+    //  max flow backend is MATCHING if not given
+    const unordered_map<string, NetworkNeck::FlowType> flow_types = {
+        {"DINIC", NetworkNeck::DINIC},
+        {"PUSH_RELABEL", NetworkNeck::PUSH_RELABEL},
+        {"MATCHING", NetworkNeck::MATCHING}};
     std::ifstream fin;
     fin.open("net_neck_settings.txt");
+    string flow_type;
     if (fin.is_open())
-        fin >> TASK_THRESHOLD >> TIME_THRESHOLD;
+        fin >> TASK_THRESHOLD >> TIME_THRESHOLD >> flow_type;
+    if (!flow_type.empty())
+    {
+        if (flow_types.find(flow_type) == flow_types.end())
+            printError("Unsupported Max Flow Backend: " + flow_type);
+        scheduler.neck_flow = flow_types.at(flow_type);
+    }
 
     // schedule causes
     int TASK_cnt = 0;
@@ -88,11 +108,12 @@ int main()
     std::cout << "TIME: " << TIME_cnt << ' '
               << "TASK: " << TASK_cnt << std::endl;
     graph->printStatistics("network_neck.log");
+    print_bound(graph, bound, sim.getTime());
     graph->printFinishTime("network_neck.txt");
     // graph->printFinishTime();
     graph->printData("network_neck_data.txt");
 
-    graph->printTasks();
+    graph->sink->close();
 
     std::cout << std::endl;
     return 0;
@@ -1,4 +1,5 @@
 #include "includes/common.hpp"
+#include "includes/analysis.hpp"
 #include "includes/DAG.hpp"
 #include "includes/scheduler.hpp"
 #include "includes/simulator.hpp"
@@ -8,6 +9,8 @@ int main()
     shared_ptr<Graph> graph;
     graph = make_shared<Graph>();
     init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
     DAG dag;
     Scheduler scheduler;
     scheduler.sched_type = Scheduler::NETWORK_SUM;
@@ -88,6 +91,7 @@ int main()
     std::cout << "TIME: " << TIME_cnt << ' '
               << "TASK: " << TASK_cnt << std::endl;
     graph->printStatistics("network_sum.log");
+    print_bound(graph, bound, sim.getTime());
     graph->printFinishTime("network_sum.txt");
     graph->printData("network_sum_data.txt");
     std::cout << std::endl;
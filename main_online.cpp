@@ -0,0 +1,91 @@
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+#include "includes/job_stream.hpp"
+
+int main()
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    // jobs are loaded when they arrive
+    init_topology(graph);
+    DAG dag;
+    Scheduler scheduler;
+    scheduler.sched_type = Scheduler::GREEDY;
+    scheduler.neck_type = Scheduler::SAME_NEXT;
+    Simulator sim;
+
+    // read settings from file
+    // e.g. "GREEDY 0.5 1 csv"
+    //  schedule with GREEDY, 0.5 jobs per second, seed 1
+    //  output in csv (or bin)
+    string policy = "GREEDY";
+    double rate = 0;
+    uint64_t seed = 1;
+    string format = "csv";
+    std::ifstream fin;
+    fin.open("online_settings.txt");
+    if (fin.is_open())
+        fin >> policy >> rate >> seed >> format;
+
+    const map<string, Scheduler::SchedType> policies = {
+        {"GREEDY", Scheduler::GREEDY},
+        {"K_GREEDY", Scheduler::K_GREEDY},
+        {"RANDOM", Scheduler::RANDOM},
+        {"NETWORK_SUM", Scheduler::NETWORK_SUM},
+        {"NETWORK_NECK", Scheduler::NETWORK_NECK}};
+    if (policies.find(policy) == policies.end())
+        printError("No Such Policy: " + policy);
+    scheduler.sched_type = policies.at(policy);
+
+    auto stream = make_shared<JobStream>();
+    stream->open(rate, seed);
+
+    // retire finished jobs to keep memory bounded
+    //  by active jobs
+    graph->retire = true;
+    graph->sink = make_shared<OutputSink>();
+    bool opened = format == "bin"
+                      ? graph->sink->open("online_tasks.bin", "online.bin",
+                                          OutputSink::BINARY)
+                      : graph->sink->open("online_tasks.csv", "online.txt");
+    if (!opened)
+        printError("Can't Open Output Files");
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    scheduler.initSeed(seed);
+    sim.updateGraph(graph);
+    sim.updateStream(stream);
+    int job_cnt = 0;
+    // lower bounds of jobs arrived so far
+    ScheduleBound bound;
+
+    while (!dag.if_finished() || sim.hasArrival())
+    {
+        for (const auto &job : sim.getArrived())
+        {
+            dag.addJob(job);
+            job_cnt++;
+        }
+        analyze_jobs(graph, bound);
+        scheduler.sumbitTasks(dag.getSubmit());
+
+        auto sched = scheduler.getScheduled();
+        sim.updateScheduled(sched);
+
+        sim.forwardTime();
+        auto finished = sim.getFinished();
+        dag.updateDAG(finished);
+    }
+    std::cout << "ONLINE " << policy << ": " << sim.getTime() << "\n";
+    std::cout << "JOBS: " << job_cnt << std::endl;
+    graph->printStatistics("online.log");
+    print_bound(graph, bound, sim.getTime());
+    graph->sink->close();
+
+    std::cout << std::endl;
+    return 0;
+}
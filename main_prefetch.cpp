@@ -0,0 +1,98 @@
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+
+struct Result
+{
+    double makespan;
+    double average;
+    // transfer seconds of tasks run where inputs were staged
+    //  and those hidden by prefetch
+    double staged;
+    double hidden;
+    int hits;
+    int misses;
+};
+
+// stage static inputs of tasks whose predecessors
+//  finish within window seconds, no prefetch if window is 0
+Result run(Scheduler::SchedType sched_type, double window)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    //  staged inputs overlap predecessors, so with prefetch
+    //  the path bound is a reference, not a strict bound
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler;
+    scheduler.sched_type = sched_type;
+    scheduler.neck_type = Scheduler::SAME_NEXT;
+    Simulator sim;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        scheduler.updateTime(sim.getTime());
+        auto sched = scheduler.getScheduled();
+        sim.updateScheduled(sched);
+        if (window > 0)
+            sim.updatePrefetch(
+                scheduler.getPrefetch(sim.getNearlyReady(window)));
+
+        sim.forwardTime(scheduler.nextWakeup());
+        dag.updateDAG(sim.getFinished());
+    }
+    graph->printStatistics("");
+    print_bound(graph, bound, sim.getTime());
+    return {sim.getTime(), graph->stats.mean, sim.staged_time,
+            sim.hidden_time, sim.prefetch_hits, sim.prefetch_misses};
+}
+
+int main()
+{
+    // read settings from file
+    // e.g. "5"
+    //  stage inputs of tasks whose predecessors
+    //  are expected to finish in 5s
+    double window = 5;
+    std::ifstream fin;
+    fin.open("prefetch_settings.txt");
+    if (fin.is_open())
+        fin >> window;
+
+    const vector<pair<string, Scheduler::SchedType>> policies = {
+        {"GREEDY", Scheduler::GREEDY},
+        {"NETWORK_SUM", Scheduler::NETWORK_SUM},
+        {"NETWORK_NECK", Scheduler::NETWORK_NECK},
+        {"DELAY", Scheduler::DELAY}};
+    vector<Result> origin, prefetch;
+    for (const auto &policy : policies)
+    {
+        std::cout << policy.first << ":" << std::endl;
+        origin.push_back(run(policy.second, 0));
+        std::cout << policy.first << " PREFETCH:" << std::endl;
+        prefetch.push_back(run(policy.second, window));
+    }
+
+    // makespan and average, without then with prefetch
+    //  seconds of transfer hidden behind predecessors
+    for (int i = 0; i < policies.size(); ++i)
+        std::cout << policies[i].first << ": "
+                  << origin[i].makespan << ' ' << origin[i].average
+                  << " -> "
+                  << prefetch[i].makespan << ' ' << prefetch[i].average
+                  << " HIDDEN: " << prefetch[i].hidden << "s of "
+                  << prefetch[i].staged << "s "
+                  << "HITS: " << prefetch[i].hits << ' '
+                  << "MISSES: " << prefetch[i].misses << '\n';
+
+    std::cout << std::endl;
+    return 0;
+}
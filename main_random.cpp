@@ -1,4 +1,5 @@
 #include "includes/common.hpp"
+#include "includes/analysis.hpp"
 #include "includes/DAG.hpp"
 #include "includes/scheduler.hpp"
 #include "includes/simulator.hpp"
@@ -8,6 +9,8 @@ int main()
     shared_ptr<Graph> graph;
     graph = make_shared<Graph>();
     init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
     DAG dag;
     Scheduler scheduler;
     scheduler.sched_type = scheduler.RANDOM;
@@ -15,6 +18,9 @@ int main()
 
     dag.init(graph);
     scheduler.initGraph(graph);
+    // same seed.txt gives same run
+    auto seed = readSeed();
+    scheduler.initSeed(seed.first, seed.second);
     sim.updateGraph(graph);
     // sim.printStatus();
     int task_cnt = 0;
@@ -38,7 +44,10 @@ int main()
         dag.updateDAG(finished);
     }
     std::cout << "RANDOM: " << sim.getTime() << "\n";
+    std::cout << "SEED: " << seed.first << ' '
+              << seed.second << std::endl;
     graph->printStatistics("random.log");
+    print_bound(graph, bound, sim.getTime());
     graph->printFinishTime("random.txt");
     graph->printData("random_data.txt");
     std::cout << std::endl;
@@ -0,0 +1,156 @@
+#include <chrono>
+#include <thread>
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+#include "includes/service.hpp"
+
+// simulator as a client of scheduler daemon
+//  a daemon is started in this process if none listens
+
+struct Result
+{
+    double makespan;
+    double average;
+    // wall time per round, a round trip if remote
+    double latency;
+    int rounds;
+};
+
+// scheduler in the same process
+Result run_local(const Scheduler &settings)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler = settings;
+    Simulator sim;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+
+    double latency = 0;
+    int rounds = 0;
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        auto start = std::chrono::steady_clock::now();
+        scheduler.updateTime(sim.getTime());
+        auto sched = scheduler.getScheduled();
+        latency += std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+        rounds++;
+        sim.updateScheduled(sched);
+
+        sim.forwardTime(scheduler.nextWakeup());
+        dag.updateDAG(sim.getFinished());
+    }
+    graph->printStatistics("");
+    print_bound(graph, bound, sim.getTime());
+    return {sim.getTime(), graph->stats.mean,
+            latency / std::max(rounds, 1), rounds};
+}
+
+// scheduler behind the socket
+//  a tick is one frame: completions, ready tasks and SCHEDULE
+Result run_remote(SchedulerClient &client)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Simulator sim;
+
+    dag.init(graph);
+    sim.updateGraph(graph);
+
+    // slots of this cluster, sent with first tick
+    for (const auto &it : graph->slots)
+        client.setSlots(it.first, it.second.first);
+
+    double latency = 0;
+    int rounds = 0;
+    while (!dag.if_finished())
+    {
+        client.submit(dag.getSubmit());
+        auto start = std::chrono::steady_clock::now();
+        auto sched = client.schedule(sim.getTime());
+        latency += std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+        rounds++;
+        sim.updateScheduled(sched);
+
+        sim.forwardTime(client.wakeup);
+        auto finished = sim.getFinished();
+        client.complete(finished);
+        dag.updateDAG(finished);
+    }
+    client.flush();
+    graph->printStatistics("remote.log");
+    print_bound(graph, bound, sim.getTime());
+    return {sim.getTime(), graph->stats.mean,
+            latency / std::max(rounds, 1), rounds};
+}
+
+int main()
+{
+    string path = "/tmp/scheduler.sock";
+    Scheduler settings;
+    read_service_settings(path, settings);
+
+    std::cout << "LOCAL:" << std::endl;
+    Result local = run_local(settings);
+
+    // graph of daemon is its own, only the socket is shared
+    shared_ptr<Graph> daemon_graph;
+    SchedulerService service;
+    std::thread daemon;
+    SchedulerClient client;
+    bool own = !client.connect(path);
+    if (own)
+    {
+        daemon_graph = make_shared<Graph>();
+        init_data(daemon_graph);
+        service.init(daemon_graph, settings);
+        service.open(path);
+        daemon = std::thread([&service]()
+                             { service.serve(); });
+        if (!client.connect(path))
+            printError("Can't Connect to " + path);
+    }
+    std::cout << "REMOTE:" << std::endl;
+    Result remote = run_remote(client);
+    // a daemon started elsewhere keeps running
+    if (own)
+    {
+        client.shutdown();
+        daemon.join();
+    }
+
+    // latency in ms, bytes per round
+    std::cout << "LOCAL: " << local.makespan << ' '
+              << local.average << ' '
+              << local.latency * 1000 << "ms\n"
+              << "REMOTE: " << remote.makespan << ' '
+              << remote.average << ' '
+              << remote.latency * 1000 << "ms "
+              << "SENT: " << client.bytes_out / std::max(remote.rounds, 1)
+              << "B RECEIVED: "
+              << client.bytes_in / std::max(remote.rounds, 1) << "B\n";
+    if (std::fabs(local.makespan - remote.makespan) > 1e-6 ||
+        std::fabs(local.average - remote.average) > 1e-6)
+        printWarning("Remote Schedule Differs from Local");
+
+    std::cout << std::endl;
+    return 0;
+}
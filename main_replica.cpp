@@ -0,0 +1,82 @@
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/replication.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+
+struct Result
+{
+    double makespan;
+    double average;
+};
+
+// event driven GREEDY, with replicas planned by planner
+//  or without replicas if planner is nullptr
+Result run(ReplicationPlanner *planner, string log_name)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    DAG dag;
+    Scheduler scheduler;
+    scheduler.sched_type = Scheduler::GREEDY;
+    Simulator sim;
+
+    if (planner)
+    {
+        planner->initGraph(graph);
+        planner->initStorage();
+        double before = planner->estimate();
+        planner->plan();
+        double after = planner->estimate();
+        std::cout << "REPLICAS: " << planner->added << '\n'
+                  << "ESTIMATED TRANSFER: " << before << " -> " << after
+                  << " SAVED: " << before - after << '\n';
+    }
+
+    // lower bounds with replicas
+    ScheduleBound bound = analyze_bound(graph);
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        auto sched = scheduler.getScheduled();
+        sim.updateScheduled(sched);
+
+        sim.forwardTime();
+        auto finished = sim.getFinished();
+        dag.updateDAG(finished);
+    }
+    graph->printStatistics(log_name);
+    print_bound(graph, bound, sim.getTime());
+    return {sim.getTime(), graph->stats.mean};
+}
+
+int main()
+{
+    ReplicationPlanner planner;
+    // read settings from file
+    // e.g. "500 2"
+    //  500 storage for replicas on each DC,
+    //  2 replicas of a resource at most
+    std::ifstream fin;
+    fin.open("replica_settings.txt");
+    if (fin.is_open())
+        fin >> planner.budget >> planner.max_replicas;
+
+    std::cout << "NO REPLICA:" << std::endl;
+    Result origin = run(nullptr, "");
+    std::cout << "REPLICA:" << std::endl;
+    Result replica = run(&planner, "replica.log");
+
+    std::cout << "NO REPLICA: " << origin.makespan << ' '
+              << origin.average << '\n'
+              << "REPLICA: " << replica.makespan << ' '
+              << replica.average << std::endl;
+
+    std::cout << std::endl;
+    return 0;
+}
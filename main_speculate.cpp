@@ -0,0 +1,95 @@
+#include "includes/common.hpp"
+#include "includes/analysis.hpp"
+#include "includes/DAG.hpp"
+#include "includes/scheduler.hpp"
+#include "includes/simulator.hpp"
+
+struct Result
+{
+    double makespan;
+    double average;
+    double p99;
+    // slot seconds of all copies and cancelled copies
+    double busy_time;
+    double wasted_time;
+};
+
+// event driven GREEDY with noisy run time
+//  launch backups of tasks lagging behind ratio * median of their jobs
+//  no backup if ratio is 0
+Result run(const Simulator &settings, double ratio, string log_name)
+{
+    shared_ptr<Graph> graph;
+    graph = make_shared<Graph>();
+    init_data(graph);
+    // lower bounds before any task runs
+    ScheduleBound bound = analyze_bound(graph);
+    DAG dag;
+    Scheduler scheduler;
+    scheduler.sched_type = Scheduler::GREEDY;
+    Simulator sim = settings;
+
+    dag.init(graph);
+    scheduler.initGraph(graph);
+    sim.updateGraph(graph);
+    while (!dag.if_finished())
+    {
+        scheduler.sumbitTasks(dag.getSubmit());
+        auto sched = scheduler.getScheduled();
+        sim.updateScheduled(sched);
+        if (ratio > 0)
+            sim.updateScheduled(scheduler.getBackups(sim.getLagging(ratio)));
+
+        sim.forwardTime();
+        auto finished = sim.getFinished();
+        dag.updateDAG(finished);
+    }
+    graph->printStatistics(log_name);
+    print_bound(graph, bound, sim.getTime());
+    std::cout << "BACKUPS: " << sim.backups << ' '
+              << "BACKUP WINS: " << sim.backup_wins << '\n';
+    return {sim.getTime(), graph->stats.mean, graph->stats.jct.quantile(0.99),
+            sim.busy_time, sim.wasted_time};
+}
+
+int main()
+{
+    Simulator settings;
+    double ratio = 0.5;
+    // read settings from file
+    // e.g. "0.2 0.05 3 2 0.5"
+    //  run time *= lognormal noise with sigma 0.2,
+    //  5% copies straggle by Pareto(3, 2),
+    //  back up tasks with progress < 0.5 * median of their jobs
+    std::ifstream fin;
+    fin.open("speculate_settings.txt");
+    if (fin.is_open())
+        fin >> settings.runtime_sigma >> settings.straggler_prob >>
+            settings.straggler_scale >> settings.straggler_shape >> ratio;
+    else
+        settings.runtime_sigma = 0.2, settings.straggler_prob = 0.05;
+    // same seed.txt gives same noise
+    auto seed = readSeed();
+    settings.initNoise(seed.first, seed.second);
+    std::cout << "SEED: " << seed.first << ' ' << seed.second << '\n';
+
+    std::cout << "NO SPECULATION:" << std::endl;
+    Result origin = run(settings, 0, "");
+    std::cout << "SPECULATION:" << std::endl;
+    Result spec = run(settings, ratio, "speculate.log");
+
+    std::cout << "NO SPECULATION: " << origin.makespan << ' '
+              << origin.average << ' ' << origin.p99 << '\n'
+              << "SPECULATION: " << spec.makespan << ' '
+              << spec.average << ' ' << spec.p99 << '\n';
+    std::cout << "P99 IMPROVE: "
+              << (origin.p99 - spec.p99) / std::max(origin.p99, 1e-9) * 100
+              << "% "
+              << "SLOT COST: "
+              << (spec.busy_time - origin.busy_time) /
+                     std::max(origin.busy_time, 1e-9) * 100
+              << "% WASTED: " << spec.wasted_time << std::endl;
+
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,270 @@
+import argparse
+import csv
+import itertools
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+# sweep workload scale x policy x seed, write one CSV/JSON artifact,
+#  and compare it with a baseline artifact
+# usage:
+#  python benchmark.py --jobs 50,500 --dcs 13,100 --seeds 1,2,3 \
+#      --policies greedy,networksum --out result.csv
+#  python benchmark.py --compare baseline.csv --out result.csv ...
+#  python benchmark.py --diff result.csv baseline.csv
+# drivers and workload_generator are looked up in --bin (compile_O3.bat)
+# exit code is 1 if any regression is found
+
+SCALE = ['jobs', 'tasks', 'dcs', 'slots_min', 'slots_max', 'topology',
+         'shape']
+KEY = SCALE + ['policy']
+METRICS = ['makespan', 'mean', 'p99', 'sched_time', 'peak_rss_kb',
+           'wall_time']
+# larger is worse for all metrics
+QUALITY = ['makespan', 'mean', 'p99']
+THROUGHPUT = ['sched_time', 'wall_time', 'peak_rss_kb']
+# smaller changes are noise, whatever the ratio is
+FLOOR = {'sched_time': 0.05, 'wall_time': 0.05, 'peak_rss_kb': 1024}
+
+EXE = '.exe' if os.name == 'nt' else ''
+
+
+def split(value, kind=str):
+    return [kind(x) for x in value.split(',') if x]
+
+
+# peak RSS in KB of a running process, '' if unknown
+def read_hwm(pid):
+    try:
+        with open('/proc/%d/status' % pid) as f:
+            for line in f:
+                if line.startswith('VmHWM:'):
+                    return int(line.split()[1])
+    except (OSError, ValueError):
+        pass
+    return ''
+
+
+# run cmd in cwd, return (stdout, wall time, peak rss in KB)
+#  stdout is None on timeout, rss is '' if os.wait4 is missing (Windows)
+def run(cmd, cwd, timeout):
+    start = time.time()
+    with tempfile.TemporaryFile() as log:
+        p = subprocess.Popen(cmd, cwd=cwd, stdout=log,
+                             stderr=subprocess.STDOUT)
+        rss = ''
+        if hasattr(os, 'wait4'):
+            # ru_maxrss counts memory of this python before exec,
+            #  so sample VmHWM of the child on Linux
+            hwm = ''
+            while True:
+                pid, status, usage = os.wait4(p.pid, os.WNOHANG)
+                if pid:
+                    p.returncode = status
+                    rss = usage.ru_maxrss
+                    if sys.platform == 'darwin':
+                        rss //= 1024
+                    rss = hwm or rss
+                    break
+                hwm = read_hwm(p.pid) or hwm
+                if time.time() - start > timeout:
+                    p.kill()
+                    p.wait()
+                    return None, time.time() - start, ''
+                time.sleep(0.002)
+        else:
+            try:
+                p.wait(timeout=timeout)
+            except subprocess.TimeoutExpired:
+                p.kill()
+                p.wait()
+                return None, time.time() - start, ''
+        wall = time.time() - start
+        log.seek(0)
+        out = log.read().decode(errors='replace')
+    return out, wall, rss
+
+
+# e.g. "GREEDY: 24.92" -> 24.92
+#  first "NAME: number" line printed by a driver
+def parse_makespan(out):
+    for line in out.splitlines():
+        m = re.match(r'^[A-Z_ ]+: ([-\d.e+]+)$', line.strip())
+        if m:
+            return float(m.group(1))
+    return ''
+
+
+# last line of a .log written by Graph::printStatistics()
+#  "mx,avg,std,key=value,..."
+def parse_log(path):
+    with open(path) as f:
+        lines = [x for x in f.read().splitlines() if x]
+    cols = lines[-1].split(',')
+    ret = {'mean': float(cols[1])}
+    for col in cols[3:]:
+        key, value = col.split('=', 1)
+        if key in ('p99', 'sched_time'):
+            ret[key] = float(value)
+    return ret
+
+
+def generate(args, scale, seed, work_dir):
+    cmd = [os.path.join(args.bin, 'workload_generator' + EXE),
+           'seed=%d' % seed, 'out=' + work_dir]
+    cmd += ['%s=%s' % (k, scale[k]) for k in SCALE]
+    out, _, _ = run(cmd, work_dir, args.timeout)
+    if out is None or 'JOBS:' not in out:
+        sys.exit('workload_generator failed: %s' % out)
+    with open(os.path.join(work_dir, 'seed.txt'), 'w') as f:
+        f.write('%d 0\n' % seed)
+
+
+def bench(args):
+    rows = []
+    grid = itertools.product(split(args.jobs, int), split(args.tasks, int),
+                             split(args.dcs, int), split(args.slots),
+                             split(args.topology), split(args.shape))
+    for jobs, tasks, dcs, slots, topology, shape in grid:
+        lo, hi = (slots.split('-') + [slots])[:2]
+        scale = {'jobs': jobs, 'tasks': tasks, 'dcs': dcs,
+                 'slots_min': int(lo), 'slots_max': int(hi),
+                 'topology': topology, 'shape': shape}
+        for seed in split(args.seeds, int):
+            work_dir = tempfile.mkdtemp(prefix='bench_')
+            try:
+                generate(args, scale, seed, work_dir)
+                for policy in split(args.policies):
+                    rows.append(bench_one(args, scale, policy, seed,
+                                          work_dir))
+            finally:
+                shutil.rmtree(work_dir, ignore_errors=True)
+    return rows
+
+
+def bench_one(args, scale, policy, seed, work_dir):
+    for name in os.listdir(work_dir):
+        if name.endswith('.log'):
+            os.remove(os.path.join(work_dir, name))
+    exe = os.path.abspath(os.path.join(args.bin, 'main_' + policy + EXE))
+    out, wall, rss = run([exe], work_dir, args.timeout)
+    row = dict(scale, policy=policy, seed=seed, wall_time=round(wall, 4),
+               peak_rss_kb=rss, status='ok')
+    if out is None:
+        row['status'] = 'timeout'
+    elif 'Error' in out:
+        row['status'] = 'error'
+    else:
+        row['makespan'] = parse_makespan(out)
+        logs = [x for x in os.listdir(work_dir) if x.endswith('.log')]
+        if logs:
+            row.update(parse_log(os.path.join(work_dir, logs[0])))
+    print(' '.join('%s=%s' % (k, row.get(k, '')) for k in
+                   KEY + ['seed', 'status'] + METRICS), flush=True)
+    return row
+
+
+def save(rows, path):
+    fields = KEY + ['seed', 'status'] + METRICS
+    if path.endswith('.json'):
+        with open(path, 'w') as f:
+            json.dump(rows, f, indent=1)
+        return
+    with open(path, 'w', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=fields)
+        writer.writeheader()
+        for row in rows:
+            writer.writerow({k: row.get(k, '') for k in fields})
+
+
+def load(path):
+    if path.endswith('.json'):
+        with open(path) as f:
+            return json.load(f)
+    with open(path, newline='') as f:
+        return list(csv.DictReader(f))
+
+
+# mean of metrics over seeds, by workload and policy
+def summarize(rows):
+    groups = {}
+    for row in rows:
+        key = tuple(str(row[k]) for k in KEY)
+        group = groups.setdefault(key, {m: [] for m in METRICS})
+        for m in METRICS:
+            if row.get('status', 'ok') == 'ok' and row.get(m, '') != '':
+                group[m].append(float(row[m]))
+            elif m in QUALITY:
+                # a failed run is a quality regression
+                group[m].append(float('inf'))
+    return {key: {m: sum(v) / len(v) for m, v in group.items() if v}
+            for key, group in groups.items()}
+
+
+# print a line per metric worse than baseline by more than tolerance
+#  return number of regressions
+def compare(rows, baseline, quality_tol, time_tol):
+    new, old = summarize(rows), summarize(baseline)
+    cnt = 0
+    for key in sorted(new):
+        if key not in old:
+            continue
+        for m in QUALITY + THROUGHPUT:
+            if m not in new[key] or m not in old[key]:
+                continue
+            tol = quality_tol if m in QUALITY else time_tol
+            a, b = new[key][m], old[key][m]
+            if a > b * (1 + tol) and a - b > FLOOR.get(m, 1e-9):
+                cnt += 1
+                kind = 'QUALITY' if m in QUALITY else 'THROUGHPUT'
+                print('%s REGRESSION %s %s: %g -> %g' %
+                      (kind, ' '.join(key), m, b, a))
+    missing = [k for k in old if k not in new]
+    print('COMPARED: %d REGRESSIONS: %d MISSING: %d' %
+          (len(new), cnt, len(missing)))
+    return cnt
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--jobs', default='50')
+    parser.add_argument('--tasks', default='8')
+    parser.add_argument('--dcs', default='13')
+    # e.g. 1-5 for 1 to 5 slots per DC
+    parser.add_argument('--slots', default='1-5')
+    parser.add_argument('--topology', default='geo')
+    parser.add_argument('--shape', default='mixed')
+    parser.add_argument('--policies',
+                        default='greedy,kgreedy,random,networksum,'
+                        'networkneck')
+    parser.add_argument('--seeds', default='1')
+    parser.add_argument('--bin', default='.')
+    parser.add_argument('--timeout', type=float, default=600)
+    parser.add_argument('--out', default='benchmark.csv')
+    parser.add_argument('--compare', help='baseline artifact')
+    parser.add_argument('--diff', nargs=2, metavar=('RESULT', 'BASELINE'),
+                        help='compare two artifacts without running')
+    # relative increase allowed
+    parser.add_argument('--quality-tol', type=float, default=0.02)
+    parser.add_argument('--time-tol', type=float, default=0.25)
+    args = parser.parse_args()
+
+    if args.diff:
+        rows, baseline = load(args.diff[0]), load(args.diff[1])
+    else:
+        rows = bench(args)
+        save(rows, args.out)
+        if not args.compare:
+            return
+        baseline = load(args.compare)
+    if compare(rows, baseline, args.quality_tol, args.time_tol):
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -5,6 +5,22 @@ g++ -O3 ../main_greedy.cpp -o main_greedy.exe
 g++ -O3 ../main_random.cpp -o main_random.exe
 g++ -O3 ../main_networkneck.cpp -o main_networkneck.exe
 g++ -O3 ../main_networksum.cpp -o main_networksum.exe
+g++ -O3 ../main_online.cpp -o main_online.exe
+g++ -O3 -pthread ../main_bestk.cpp -o main_bestk.exe
+g++ -O3 -pthread ../main_mcts.cpp -o main_mcts.exe
+g++ -O3 ../main_delay.cpp -o main_delay.exe
+g++ -O3 ../main_replica.cpp -o main_replica.exe
+g++ -O3 ../main_speculate.cpp -o main_speculate.exe
+g++ -O3 -pthread ../main_hierarchy.cpp -o main_hierarchy.exe
+g++ -O3 ../main_flowbench.cpp -o main_flowbench.exe
+g++ -O3 -pthread ../main_async.cpp -o main_async.exe
+g++ -O3 ../main_bandwidth.cpp -o main_bandwidth.exe
+g++ -O3 -pthread ../main_multipath.cpp -o main_multipath.exe
+g++ -O3 ../main_prefetch.cpp -o main_prefetch.exe
+rem Unix domain sockets, Linux, macOS or WSL
+g++ -O3 -pthread ../main_daemon.cpp -o main_daemon.exe
+g++ -O3 -pthread ../main_remote.cpp -o main_remote.exe
+g++ -O3 workload_generator.cpp -o workload_generator.exe
 
 
 pause&&exit
\ No newline at end of file
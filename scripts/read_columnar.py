@@ -0,0 +1,69 @@
+import struct
+import sys
+
+
+# convert binary output of OutputSink to csv
+# usage: python read_columnar.py online_tasks.bin > tasks.csv
+
+
+def read_string(data, pos):
+    n = struct.unpack_from('<H', data, pos)[0]
+    pos += 2
+    return data[pos:pos + n].decode(), pos + n
+
+
+def read_doubles(data, pos, rows):
+    values = struct.unpack_from('<%dd' % rows, data, pos)
+    return values, pos + 8 * rows
+
+
+def read_tasks(data, pos):
+    DC = []
+    while pos < len(data):
+        rows, new_dc = struct.unpack_from('<II', data, pos)
+        pos += 8
+        for i in range(new_dc):
+            name, pos = read_string(data, pos)
+            DC.append(name)
+        names = []
+        for i in range(rows):
+            name, pos = read_string(data, pos)
+            names.append(name)
+        DC_id = struct.unpack_from('<%dI' % rows, data, pos)
+        pos += 4 * rows
+        start, pos = read_doubles(data, pos, rows)
+        transfer, pos = read_doubles(data, pos, rows)
+        run_time, pos = read_doubles(data, pos, rows)
+        for i in range(rows):
+            print('%s,%s,%g,%g,%g' % (names[i], DC[DC_id[i]], start[i],
+                                      transfer[i], run_time[i]))
+
+
+def read_jobs(data, pos):
+    while pos < len(data):
+        rows = struct.unpack_from('<I', data, pos)[0]
+        pos += 4
+        names = []
+        for i in range(rows):
+            name, pos = read_string(data, pos)
+            names.append(name)
+        finish_time, pos = read_doubles(data, pos, rows)
+        for i in range(rows):
+            print('%s %.4g' % (names[i], finish_time[i]))
+
+
+def main():
+    with open(sys.argv[1], 'rb') as f:
+        data = f.read()
+    magic = data[:4]
+    pos = 8  # magic and version
+    if magic == b'SPAN':
+        read_tasks(data, pos)
+    elif magic == b'JOBS':
+        read_jobs(data, pos)
+    else:
+        print('unknown file')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,434 @@
+#include <cstdio>
+#include "../includes/common.hpp"
+
+// generate job_list.json, constraint.json, DC.json and link.json
+//  or job_stream.jsonl instead of the first two,
+//  same in every run with the same arguments
+//
+// usage: workload_generator [key=value ...]
+// e.g. workload_generator jobs=100000 tasks=10 shape=mixed dcs=100
+//                         topology=geo format=jsonl out=../data
+//
+// tasks of a job are numbered in topological order,
+//  so every shape is a DAG
+// runtimes and sizes are Pareto (heavy tailed), capped at 100 * mean
+// memory is O(dcs + resources), jobs are written once generated
+
+// e.g. {"jobs","50"}
+map<string, string> args = {
+    {"seed", "1"},
+    {"jobs", "50"},
+    // mean tasks per job, lognormal
+    {"tasks", "8"},
+    {"max_tasks", "1000"},
+    // chain, forkjoin, mapreduce, layered or mixed
+    {"shape", "mixed"},
+    // inputs of a task read at most fan_in outputs of prev stage
+    {"fan_in", "4"},
+    // static resources a task reads at most
+    {"inputs", "3"},
+    {"time_mean", "3"},
+    {"time_alpha", "2.5"},
+    {"size_mean", "400"},
+    {"size_alpha", "1.5"},
+    {"output_mean", "150"},
+    {"output_alpha", "2"},
+    // jobs per second, no "arrival" if 0
+    {"rate", "0"},
+    {"dcs", "13"},
+    // mesh, star, fattree or geo
+    {"topology", "geo"},
+    {"slots_min", "1"},
+    {"slots_max", "5"},
+    // probability that a resource is on the home DC of its job
+    {"locality", "0.5"},
+    // json or jsonl
+    {"format", "json"},
+    {"out", "."},
+};
+
+double getDouble(const string &key)
+{
+    return std::stod(args.at(key));
+}
+
+int getInt(const string &key)
+{
+    return std::stoi(args.at(key));
+}
+
+// Pareto with mean and shape alpha > 1
+double drawPareto(Rng &gen, double mean, double alpha)
+{
+    double xm = mean * (alpha - 1) / alpha;
+    double u = 1 - gen.uniform();
+    return std::min(xm / std::pow(u, 1 / alpha), 100 * mean);
+}
+
+// lognormal with mean and sigma
+//  Box-Muller, same on every standard library
+double drawLognormal(Rng &gen, double mean, double sigma)
+{
+    double u = 1 - gen.uniform(), v = gen.uniform();
+    double z = std::sqrt(-2 * std::log(u)) * std::cos(2 * M_PI * v);
+    return mean * std::exp(sigma * z - sigma * sigma / 2);
+}
+
+// -----> DAG begin
+
+// e.g. {{0,1},{0,2}}
+//  task 1 and task 2 need the result of task 0
+typedef vector<pair<int, int>> EdgeList;
+
+EdgeList chainEdges(int n)
+{
+    EdgeList ret;
+    for (int i = 1; i < n; ++i)
+        ret.push_back(make_pair(i - 1, i));
+    return ret;
+}
+
+// 0 -> 1..n-2 -> n-1
+EdgeList forkJoinEdges(int n)
+{
+    if (n < 3)
+        return chainEdges(n);
+    EdgeList ret;
+    for (int i = 1; i < n - 1; ++i)
+    {
+        ret.push_back(make_pair(0, i));
+        ret.push_back(make_pair(i, n - 1));
+    }
+    return ret;
+}
+
+// tasks [begin[k], begin[k+1]) in k-th stage
+//  each task reads fan_in tasks of prev stage,
+//  all of them if prev stage is small (shuffle)
+EdgeList stageEdges(Rng &gen, const vector<int> &begin, int fan_in)
+{
+    EdgeList ret;
+    for (int k = 1; k + 1 < begin.size(); ++k)
+    {
+        int prev = begin[k - 1], width = begin[k] - begin[k - 1];
+        for (int i = begin[k]; i < begin[k + 1]; ++i)
+        {
+            if (width <= fan_in)
+            {
+                for (int j = prev; j < begin[k]; ++j)
+                    ret.push_back(make_pair(j, i));
+                continue;
+            }
+            // a random window of prev stage
+            int offset = gen.randInt(0, width - 1);
+            for (int j = 0; j < fan_in; ++j)
+                ret.push_back(make_pair(prev + (offset + j) % width, i));
+        }
+    }
+    return ret;
+}
+
+// map (60%), reduce (30%) and merge stages
+EdgeList mapReduceEdges(Rng &gen, int n, int fan_in)
+{
+    if (n < 3)
+        return chainEdges(n);
+    int map = std::max(1, int(n * 0.6));
+    int reduce = std::max(1, std::min(n - map - 1, int(n * 0.3)));
+    return stageEdges(gen, {0, map, map + reduce, n}, fan_in);
+}
+
+// sqrt(n) layers of random width
+EdgeList layeredEdges(Rng &gen, int n, int fan_in)
+{
+    int layers = std::max(1, int(std::round(std::sqrt(n))));
+    vector<int> begin = {0};
+    for (int k = 1; k < layers; ++k)
+        begin.push_back(gen.randInt(1, n - 1));
+    begin.push_back(n);
+    std::sort(begin.begin(), begin.end());
+    begin.erase(std::unique(begin.begin(), begin.end()), begin.end());
+
+    EdgeList ret;
+    for (int k = 1; k + 1 < begin.size(); ++k)
+    {
+        int width = begin[k] - begin[k - 1];
+        for (int i = begin[k]; i < begin[k + 1]; ++i)
+        {
+            int cnt = gen.randInt(1, std::min(width, fan_in));
+            set<int> prev;
+            while (prev.size() < cnt)
+                prev.insert(gen.randInt(begin[k - 1], begin[k] - 1));
+            for (int j : prev)
+                ret.push_back(make_pair(j, i));
+        }
+    }
+    return ret;
+}
+
+EdgeList drawEdges(Rng &gen, const string &shape, int n, int fan_in)
+{
+    if (shape == "chain")
+        return chainEdges(n);
+    if (shape == "forkjoin")
+        return forkJoinEdges(n);
+    if (shape == "mapreduce")
+        return mapReduceEdges(gen, n, fan_in);
+    if (shape == "layered")
+        return layeredEdges(gen, n, fan_in);
+    if (shape == "mixed")
+    {
+        static const vector<string> shapes = {"chain", "forkjoin",
+                                              "mapreduce", "layered"};
+        return drawEdges(gen, shapes[gen.randInt(0, 3)], n, fan_in);
+    }
+    printError("No Such Shape: " + shape);
+    return {};
+}
+
+// <----- DAG end
+
+// -----> topology begin
+
+// bandwidth of link u -> v, -1 if no link
+//  symmetric, drawn from its own stream
+int linkBandwidth(const string &topology, int dcs, int u, int v)
+{
+    if (u == v)
+        return 1200;
+    int lo = std::min(u, v), hi = std::max(u, v);
+    Rng gen(getInt("seed"), "link", uint64_t(lo) * dcs + hi);
+    auto pick = [&gen](const vector<int> &values)
+    { return values[gen.randInt(0, values.size() - 1)]; };
+
+    if (topology == "mesh")
+        return pick({50, 80, 100, 120, 150, 200, 300, 500});
+    if (topology == "star")
+        // DC1 is the hub
+        return lo == 0 ? pick({300, 500, 800}) : -1;
+    if (topology == "fattree")
+    {
+        // pods of 4 DCs, first of a pod is its aggregation DC
+        //  aggregation DCs of first cores pods are core DCs
+        //  links are fatter near the core
+        const int pod = 4;
+        int cores = std::max(1, (dcs / pod + 7) / 8);
+        bool agg_lo = lo % pod == 0, agg_hi = hi % pod == 0;
+        if (lo / pod == hi / pod)
+            return agg_lo ? 300 : -1;
+        if (agg_lo && agg_hi && lo / pod < cores)
+            return 1000;
+        return -1;
+    }
+    if (topology == "geo")
+    {
+        // sqrt(dcs) regions, first DC of a region is its gateway
+        //  fast links in a region, slow links between gateways,
+        //  and a few slow links between other DCs
+        int regions = std::max(1, int(std::sqrt(dcs)));
+        int size = (dcs + regions - 1) / regions;
+        if (lo / size == hi / size)
+            return pick({300, 500, 800});
+        if (lo % size == 0 && hi % size == 0)
+            return pick({80, 120, 150});
+        return gen.uniform() < 0.02 ? pick({50, 80}) : -1;
+    }
+    printError("No Such Topology: " + topology);
+    return -1;
+}
+
+// <----- topology end
+
+// buffered text file
+class TextFile
+{
+private:
+    FILE *file = nullptr;
+
+public:
+    void open(const string &file_name)
+    {
+        file = fopen(file_name.c_str(), "wb");
+        if (!file)
+            printError("Cannot Open " + file_name);
+    }
+
+    void write(const string &str)
+    {
+        fwrite(str.data(), 1, str.size(), file);
+    }
+
+    void close()
+    {
+        if (file)
+            fclose(file);
+        file = nullptr;
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        auto pos = arg.find('=');
+        if (pos == string::npos || args.find(arg.substr(0, pos)) == args.end())
+            printError("Unknown Argument: " + arg);
+        args[arg.substr(0, pos)] = arg.substr(pos + 1);
+    }
+    uint64_t seed = getInt("seed");
+    int jobs = getInt("jobs"), dcs = getInt("dcs");
+    int fan_in = std::max(1, getInt("fan_in"));
+    int inputs = std::max(1, getInt("inputs"));
+    double rate = getDouble("rate"), locality = getDouble("locality");
+    string shape = args["shape"], topology = args["topology"];
+    string out = args["out"] + "/";
+    bool stream = args["format"] == "jsonl";
+    if (!stream && args["format"] != "json")
+        printError("No Such Format: " + args["format"]);
+    if (dcs <= 0)
+        printError("No DC");
+
+    TextFile job_file, constraint_file;
+    if (stream)
+        job_file.open(out + "job_stream.jsonl");
+    else
+    {
+        job_file.open(out + "job_list.json");
+        constraint_file.open(out + "constraint.json");
+        job_file.write("{\"job\":[\n");
+        constraint_file.write("{\"constraint\":[\n");
+    }
+
+    // e.g. {{3,0}}
+    //  job3_resource0 is on this DC
+    vector<vector<pair<int, int>>> DC_data(dcs);
+    long long task_cnt = 0, edge_cnt = 0;
+    bool first_constraint = true;
+    double arrival = 0;
+    Rng arrival_gen(seed, "arrival");
+    for (int i = 0; i < jobs; ++i)
+    {
+        Rng gen(seed, "job", i);
+        string job_id = "job" + std::to_string(i);
+        int n = std::round(drawLognormal(gen, getDouble("tasks"), 1));
+        n = std::max(1, std::min(n, getInt("max_tasks")));
+        EdgeList edges = drawEdges(gen, shape, n, fan_in);
+
+        // static resources of this job
+        //  on its home DC with probability locality
+        int num_of_resource = std::max(1, n / 2);
+        int home = gen.randInt(0, dcs - 1);
+        for (int k = 0; k < num_of_resource; ++k)
+        {
+            int DC = gen.uniform() < locality ? home
+                                              : gen.randInt(0, dcs - 1);
+            DC_data[DC].push_back(make_pair(i, k));
+        }
+
+        json job;
+        job["name"] = job_id;
+        if (rate > 0)
+        {
+            arrival += -std::log(1 - arrival_gen.uniform()) / rate;
+            job["arrival"] = arrival;
+        }
+        json &task_list = job["task"] = json::array();
+        for (int k = 0; k < n; ++k)
+        {
+            json task;
+            task["name"] = job_id + "_task" + std::to_string(k);
+            task["time"] = drawPareto(gen, getDouble("time_mean"),
+                                      getDouble("time_alpha"));
+            task["resource"] = json::array();
+            int cnt = gen.randInt(1, std::min(inputs, num_of_resource));
+            set<int> used;
+            while (used.size() < cnt)
+                used.insert(gen.randInt(0, num_of_resource - 1));
+            for (int r : used)
+                task["resource"].push_back(
+                    {{"name", job_id + "_resource" + std::to_string(r)},
+                     {"size", drawPareto(gen, getDouble("size_mean"),
+                                         getDouble("size_alpha"))}});
+            task_list.push_back(std::move(task));
+        }
+
+        // outputs of prev tasks are resources too
+        json constraint = json::array();
+        for (const auto &e : edges)
+        {
+            const json &prev = task_list[e.first]["name"];
+            task_list[e.second]["resource"].push_back(
+                {{"name", prev},
+                 {"size", drawPareto(gen, getDouble("output_mean"),
+                                     getDouble("output_alpha"))}});
+            constraint.push_back(
+                {{"start", prev}, {"end", task_list[e.second]["name"]}});
+        }
+        task_cnt += n;
+        edge_cnt += edges.size();
+
+        if (stream)
+        {
+            job["constraint"] = std::move(constraint);
+            job_file.write(job.dump() + "\n");
+            continue;
+        }
+        job_file.write((i ? ",\n" : "") + job.dump());
+        for (const auto &it : constraint)
+        {
+            constraint_file.write((first_constraint ? "" : ",\n") +
+                                  it.dump());
+            first_constraint = false;
+        }
+    }
+    if (!stream)
+    {
+        job_file.write("\n]}\n");
+        constraint_file.write("\n]}\n");
+        constraint_file.close();
+    }
+    job_file.close();
+
+    // DC.json
+    Rng slot_gen(seed, "slots");
+    TextFile DC_file;
+    DC_file.open(out + "DC.json");
+    DC_file.write("{\"DC\":[\n");
+    for (int u = 0; u < dcs; ++u)
+    {
+        json DC;
+        DC["name"] = "DC" + std::to_string(u + 1);
+        DC["size"] = slot_gen.randInt(getInt("slots_min"),
+                                      getInt("slots_max"));
+        DC["data"] = json::array();
+        for (const auto &it : DC_data[u])
+            DC["data"].push_back("job" + std::to_string(it.first) +
+                                 "_resource" + std::to_string(it.second));
+        DC_file.write((u ? ",\n" : "") + DC.dump());
+    }
+    DC_file.write("\n]}\n");
+    DC_file.close();
+
+    // link.json, a row at a time
+    TextFile link_file;
+    link_file.open(out + "link.json");
+    link_file.write("{\"link\":[\n");
+    for (int u = 0; u < dcs; ++u)
+    {
+        string row = "{\"start\":\"DC" + std::to_string(u + 1) +
+                     "\",\"bandwidth\":[";
+        for (int v = 0; v < dcs; ++v)
+            row += (v ? "," : "") +
+                   std::to_string(linkBandwidth(topology, dcs, u, v));
+        link_file.write(row + (u + 1 < dcs ? "]},\n" : "]}\n"));
+    }
+    link_file.write("]}\n");
+    link_file.close();
+
+    std::cout << "JOBS: " << jobs << ' '
+              << "TASKS: " << task_cnt << ' '
+              << "CONSTRAINTS: " << edge_cnt << ' '
+              << "DCS: " << dcs << std::endl;
+    return 0;
+}
@@ -14,17 +14,17 @@ void test_scheduler()
     edge.insert(make_pair("DC2", 90));
     edge.insert(make_pair("DC3", 70));
     edge.insert(make_pair("DC1", 1000));
-    graph->edges.insert(make_pair("DC1", edge));
+    graph->workload->edges.insert(make_pair("DC1", edge));
     edge.clear();
     edge.insert(make_pair("DC1", 100));
     edge.insert(make_pair("DC2", 1000));
     edge.insert(make_pair("DC3", 130));
-    graph->edges.insert(make_pair("DC2", edge));
+    graph->workload->edges.insert(make_pair("DC2", edge));
     edge.clear();
     edge.insert(make_pair("DC1", 50));
     edge.insert(make_pair("DC2", 110));
     edge.insert(make_pair("DC3", 1000));
-    graph->edges.insert(make_pair("DC3", edge));
+    graph->workload->edges.insert(make_pair("DC3", edge));
     edge.clear();
 
     //require  initial
@@ -33,17 +33,17 @@ void test_scheduler()
     req.push_back(make_pair("A1", 200));
     req.push_back(make_pair("A2", 300));
     req.push_back(make_pair("A3", 100));
-    graph->require.insert(make_pair("tA1", req));
+    graph->workload->require.insert(make_pair("tA1", req));
     //tA2
     req.push_back(make_pair("A1", 300));
     req.push_back(make_pair("A2", 100));
     req.push_back(make_pair("A3", 200));
-    graph->require.insert(make_pair("tA2", req));
+    graph->workload->require.insert(make_pair("tA2", req));
 
     //loc initial
-    graph->resource_loc.insert(make_pair("A1", "DC1"));
-    graph->resource_loc.insert(make_pair("A2", "DC2"));
-    graph->resource_loc.insert(make_pair("A3", "DC3"));
+    graph->workload->resource_loc.insert(make_pair("A1", "DC1"));
+    graph->workload->resource_loc.insert(make_pair("A2", "DC2"));
+    graph->workload->resource_loc.insert(make_pair("A3", "DC3"));
 
     //slots initial
     unordered_set<string> res;
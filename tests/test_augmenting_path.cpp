@@ -0,0 +1,193 @@
+#include "common.hpp"
+#include "augmenting_path.hpp"
+
+// PairingHeap against std::set, AugmentingPath against SPFA
+//  which NetworkSum and NetworkNeck used before
+// reverse edges carry +cost in those networks, with real costs
+//  no paths tie, so the residual networks must be the same
+// with -cost and integer costs many paths tie,
+//  so only flow and cost must be the same
+// g++ -O2 -std=c++17 -I includes tests/test_augmenting_path.cpp
+
+struct Edge
+{
+    int v, cap, next;
+    double cost;
+};
+
+// random push, decrease and pop of 64 nodes, keys tie
+string test_heap(Rng &gen)
+{
+    const int n = 64;
+    PairingHeap heap;
+    heap.init(n);
+    set<pair<double, int>> ref;
+    vector<double> key(n);
+    vector<bool> in(n, false);
+    for (int step = 0; step < 2000; ++step)
+    {
+        int x = gen.randInt(0, n - 1), op = gen.randInt(0, 9);
+        if (op == 0)
+        {
+            heap.clear(), ref.clear();
+            in.assign(n, false);
+        }
+        else if (op < 4 && !in[x])
+        {
+            key[x] = gen.randInt(0, 50);
+            heap.push(x, key[x]);
+            ref.emplace(key[x], x), in[x] = true;
+        }
+        else if (op < 7 && in[x])
+        {
+            ref.erase({key[x], x});
+            key[x] = gen.randInt(0, key[x]);
+            heap.decrease(x, key[x]);
+            ref.emplace(key[x], x);
+        }
+        else if (!ref.empty())
+        {
+            int y = heap.pop();
+            if (y < 0 || y >= n || !in[y] || key[y] != ref.begin()->first)
+                return "step " + std::to_string(step) + ": wrong pop";
+            ref.erase({key[y], y}), in[y] = false;
+        }
+        if (heap.empty() != ref.empty())
+            return "step " + std::to_string(step) + ": wrong empty()";
+    }
+    return "";
+}
+
+struct Network
+{
+    int n, source, sink;
+    vector<int> head;
+    vector<Edge> edges;
+
+    // reverse edge costs sign * cost
+    void addEdges(int u, int v, int cap, double cost, int sign)
+    {
+        edges.push_back({v, cap, head[u], cost});
+        head[u] = edges.size() - 1;
+        edges.push_back({u, 0, head[v], sign * cost});
+        head[v] = edges.size() - 1;
+    }
+
+    // SPFA before AugmentingPath, augments one path
+    int SPFA()
+    {
+        vector<double> dis(n, std::numeric_limits<double>::max());
+        vector<int> cap(n, 0), prev(n);
+        vector<bool> inq(n, false);
+        std::queue<int> Q;
+        dis[source] = 0;
+        cap[source] = std::numeric_limits<int>::max();
+        inq[source] = true;
+        Q.push(source);
+        while (!Q.empty())
+        {
+            int x = Q.front();
+            Q.pop(), inq[x] = false;
+            for (int i = head[x]; ~i; i = edges[i].next)
+            {
+                int to = edges[i].v;
+                if (edges[i].cap > 0 && dis[x] + edges[i].cost < dis[to])
+                {
+                    dis[to] = dis[x] + edges[i].cost;
+                    prev[to] = i;
+                    cap[to] = std::min(cap[x], edges[i].cap);
+                    if (!inq[to])
+                        Q.push(to), inq[to] = true;
+                }
+            }
+        }
+        for (int i = sink; cap[sink] && i != source; i = edges[prev[i] ^ 1].v)
+        {
+            edges[prev[i]].cap -= cap[sink];
+            edges[prev[i] ^ 1].cap += cap[sink];
+        }
+        return cap[sink];
+    }
+
+    // cost of flow on forward edges
+    double cost(const vector<int> &caps) const
+    {
+        double ret = 0;
+        for (int i = 0; i < edges.size(); i += 2)
+            ret += (caps[i] - edges[i].cap) * edges[i].cost;
+        return ret;
+    }
+};
+
+// a few nodes with random links, sometimes parallel,
+//  and some edges never worth using in NetworkNeck's way
+Network generate(Rng &gen, int sign)
+{
+    Network ret;
+    ret.n = gen.randInt(2, 30);
+    ret.source = 0, ret.sink = ret.n - 1;
+    ret.head.assign(ret.n, -1);
+    int m = gen.randInt(1, 4 * ret.n);
+    for (int i = 0; i < m; ++i)
+    {
+        int u = gen.randInt(0, ret.n - 1), v = gen.randInt(0, ret.n - 1);
+        if (u == v)
+            continue;
+        double cost = sign < 0 ? gen.randInt(0, 10) : 100 * gen.uniform();
+        if (sign > 0 && gen.uniform() < 0.05)
+            cost = std::numeric_limits<double>::max();
+        ret.addEdges(u, v, gen.randInt(1, 5), cost, sign);
+    }
+    return ret;
+}
+
+string test_flow(Rng &gen, int sign)
+{
+    Network ref = generate(gen, sign), net = ref;
+    vector<int> caps;
+    for (const auto &it : ref.edges)
+        caps.push_back(it.cap);
+
+    int expect = 0, new_flow;
+    while ((new_flow = ref.SPFA()))
+        expect += new_flow;
+    AugmentingPath<Edge> path;
+    path.init(net.n, net.source, net.sink);
+    int flow = path.minCostFlow(net.head, net.edges, &Edge::cost);
+
+    if (flow != expect)
+        return "flow " + std::to_string(flow) + " instead of " +
+               std::to_string(expect);
+    if (sign > 0)
+    {
+        for (int i = 0; i < net.edges.size(); ++i)
+            if (net.edges[i].cap != ref.edges[i].cap)
+                return "residual of edge " + std::to_string(i) + " differs";
+    }
+    else if (fabs(net.cost(caps) - ref.cost(caps)) > 1e-6)
+        return "cost " + std::to_string(net.cost(caps)) + " instead of " +
+               std::to_string(ref.cost(caps));
+    return "";
+}
+
+int main()
+{
+    int failed = 0;
+    for (int round = 0; round < 300; ++round)
+    {
+        Rng gen(1, "augmenting_path", round);
+        vector<pair<string, string>> errors = {
+            {"PairingHeap", test_heap(gen)},
+            {"AugmentingPath +cost", test_flow(gen, 1)},
+            {"AugmentingPath -cost", test_flow(gen, -1)}};
+        for (const auto &it : errors)
+            if (!it.second.empty())
+            {
+                std::cout << "round " << round << ' ' << it.first << ": "
+                          << it.second << '\n';
+                failed++;
+            }
+    }
+    std::cout << (failed ? "FAILED" : "PASSED") << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,185 @@
+#include "common.hpp"
+#include "network_neck.hpp"
+
+// max flow backends of NetworkNeck against a plain reference
+//  DINIC, PUSH_RELABEL and MATCHING, FAIR and SIMPLE
+// which task fills which slot below the bottleneck may differ,
+//  as many assignments tie, but every task must get one slot
+//  of a DC it can go to, and the worst cost must be the least
+//  possible, found here by Kuhn's matching over sorted costs
+// g++ -O2 -std=c++17 -I includes tests/test_network_neck.cpp
+
+typedef pair<double, pair<string, string>> Assign;
+
+struct ReadySet
+{
+    int task_num;
+    vector<vector<string>> task_group;
+    vector<pair<string, int>> cap_info;
+    vector<Assign> assign_info;
+};
+
+// some tasks can not go to some DCs, but each task
+//  has a home DC with a slot for it, so all get one
+ReadySet generate(Rng &gen, bool integer)
+{
+    ReadySet ret;
+    int tasks = gen.randInt(1, 40), DCs = gen.randInt(1, 8);
+    int group_size = gen.randInt(1, 4);
+    ret.task_num = tasks;
+    for (int i = 0; i < DCs; ++i)
+        ret.cap_info.emplace_back("DC" + std::to_string(i + 1),
+                                  gen.randInt(0, 2));
+    for (int i = 0; i < tasks; ++i)
+    {
+        string task = "t" + std::to_string(i);
+        if (i % group_size == 0)
+            ret.task_group.push_back({});
+        ret.task_group.back().push_back(task);
+        int home = gen.randInt(0, DCs - 1);
+        ret.cap_info[home].second++;
+        for (int k = 0; k < DCs; ++k)
+        {
+            if (k != home && gen.uniform() < 0.3)
+                continue;
+            double cost = integer ? gen.randInt(1, 5)
+                                  : 1 + 100 * gen.uniform();
+            ret.assign_info.emplace_back(
+                cost, make_pair(ret.cap_info[k].first, task));
+        }
+    }
+    return ret;
+}
+
+vector<Assign> run(const ReadySet &ready, NetworkNeck::SchedType sched_type,
+                   NetworkNeck::FlowType flow_type)
+{
+    NetworkNeck net_neck;
+    net_neck.sched_type = sched_type;
+    net_neck.flow_type = flow_type;
+    net_neck.initNetwork(ready.task_num, ready.task_group,
+                         ready.cap_info, ready.assign_info);
+    return net_neck.getSched();
+}
+
+// augmenting path from task t over edges costing at most bound
+bool kuhn(const ReadySet &ready, double bound, const string &t,
+          map<string, vector<string>> &slot, set<string> &seen)
+{
+    for (const auto &it : ready.assign_info)
+    {
+        const string &DC = it.second.first;
+        if (it.second.second != t || it.first > bound || seen.count(DC))
+            continue;
+        seen.insert(DC);
+        int cap = 0;
+        for (const auto &c : ready.cap_info)
+            if (c.first == DC)
+                cap = c.second;
+        if (slot[DC].size() < cap)
+        {
+            slot[DC].push_back(t);
+            return true;
+        }
+        for (auto &u : slot[DC])
+        {
+            string v = u;
+            u = t;
+            if (kuhn(ready, bound, v, slot, seen))
+                return true;
+            u = v;
+        }
+    }
+    return false;
+}
+
+// least worst cost of assigning all tasks
+double bottleneck(const ReadySet &ready)
+{
+    vector<double> values;
+    for (const auto &it : ready.assign_info)
+        values.push_back(it.first);
+    std::sort(values.begin(), values.end());
+    for (double bound : values)
+    {
+        map<string, vector<string>> slot;
+        int matched = 0;
+        for (const auto &group : ready.task_group)
+            for (const auto &t : group)
+            {
+                set<string> seen;
+                matched += kuhn(ready, bound, t, slot, seen);
+            }
+        if (matched == ready.task_num)
+            return bound;
+    }
+    return -1;
+}
+
+// empty if fine, or what is wrong
+string check(const ReadySet &ready, const vector<Assign> &assigned,
+             double worst)
+{
+    if (assigned.size() != ready.task_num)
+        return "assigned " + std::to_string(assigned.size()) + " tasks";
+    set<Assign> edges(ready.assign_info.begin(), ready.assign_info.end());
+    map<string, int> used;
+    set<string> tasks;
+    double ret = 0;
+    for (const auto &it : assigned)
+    {
+        if (!edges.count(it))
+            return "no such assignment " + it.second.second;
+        if (!tasks.insert(it.second.second).second)
+            return "task assigned twice " + it.second.second;
+        used[it.second.first]++;
+        ret = std::max(ret, it.first);
+    }
+    for (const auto &it : ready.cap_info)
+        if (used[it.first] > it.second)
+            return "too many tasks in " + it.first;
+    if (fabs(ret - worst) > 1e-9)
+        return "worst " + std::to_string(ret) + " instead of " +
+               std::to_string(worst);
+    return "";
+}
+
+// printError() exits with 0, fail if it stops the test
+bool finished = false;
+
+int main()
+{
+    std::atexit([]()
+                {
+                    if (!finished)
+                        std::_Exit(1);
+                });
+    const vector<pair<string, NetworkNeck::FlowType>> backends = {
+        {"DINIC", NetworkNeck::DINIC},
+        {"PUSH_RELABEL", NetworkNeck::PUSH_RELABEL},
+        {"MATCHING", NetworkNeck::MATCHING}};
+    const vector<pair<string, NetworkNeck::SchedType>> policies = {
+        {"FAIR", NetworkNeck::FAIR},
+        {"SIMPLE", NetworkNeck::SIMPLE}};
+    int failed = 0;
+    for (int round = 0; round < 400; ++round)
+    {
+        Rng gen(1, "network_neck", round);
+        ReadySet ready = generate(gen, round % 2);
+        double worst = bottleneck(ready);
+        for (const auto &policy : policies)
+            for (const auto &backend : backends)
+            {
+                string error = check(
+                    ready, run(ready, policy.second, backend.second), worst);
+                if (error.empty())
+                    continue;
+                std::cout << "round " << round << ' ' << policy.first << ' '
+                          << backend.first << ": " << error << '\n';
+                failed++;
+            }
+    }
+    std::cout << (failed ? "FAILED" : "PASSED") << std::endl;
+    finished = true;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+#include "common.hpp"
+
+// OutputLoc against unordered_map, over forks of forks
+//  random set, erase and fork on any copy, each copy must keep
+//  its own entries whatever is done to the others
+// g++ -O2 -std=c++17 -I includes tests/test_output_loc.cpp
+
+int main()
+{
+    int failed = 0;
+    for (int round = 0; round < 50 && !failed; ++round)
+    {
+        Rng gen(1, "output_loc", round);
+        vector<OutputLoc> locs(1);
+        vector<unordered_map<string, string>> refs(1);
+        for (int step = 0; step < 1000; ++step)
+        {
+            int i = gen.randInt(0, locs.size() - 1), op = gen.randInt(0, 19);
+            string task = "t" + std::to_string(gen.randInt(0, 300));
+            if (op == 0 && locs.size() < 16)
+            {
+                locs.push_back(locs[i].fork());
+                refs.push_back(refs[i]);
+            }
+            else if (op < 4)
+            {
+                locs[i].erase(task);
+                refs[i].erase(task);
+            }
+            else
+            {
+                string DC = "DC" + std::to_string(gen.randInt(1, 13));
+                locs[i].set(task, DC);
+                refs[i][task] = DC;
+            }
+
+            // copy changed, and all of them now and then
+            for (int k = 0; k < locs.size(); ++k)
+                for (int t = 0; t <= 300 && (k == i || step % 50 == 0); ++t)
+                {
+                    string name = "t" + std::to_string(t);
+                    auto iter = refs[k].find(name);
+                    const string *got = locs[k].find(name);
+                    if ((iter == refs[k].end()) != (got == nullptr) ||
+                        (got && *got != iter->second))
+                    {
+                        std::cout << "round " << round << " step " << step
+                                  << ": copy " << k << " differs at "
+                                  << name << '\n';
+                        failed++;
+                        k = locs.size();
+                        break;
+                    }
+                }
+            if (failed)
+                break;
+        }
+    }
+    std::cout << (failed ? "FAILED" : "PASSED") << std::endl;
+    return failed ? 1 : 0;
+}
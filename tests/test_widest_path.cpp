@@ -0,0 +1,72 @@
+#include "common.hpp"
+
+// WidestPaths::setLink() against build() from scratch
+//  random links changed one by one, weights from a few values
+//  so that many paths tie, as in link.json
+// g++ -O2 -std=c++17 -I includes tests/test_widest_path.cpp
+
+const double NONE = link_weight(-1);
+
+// e.g. {100, 50, 20, -1}, -1 if there is no link
+double random_weight(Rng &gen)
+{
+    static const double bandwidth[] = {20, 50, 100, 150, -1};
+    return link_weight(bandwidth[gen.randInt(0, 4)]);
+}
+
+bool same(const WidestPaths &a, const WidestPaths &b)
+{
+    return a.dis == b.dis;
+}
+
+int main()
+{
+    int failed = 0;
+    for (int round = 0; round < 200; ++round)
+    {
+        Rng gen(1, "widest_path", round);
+        int n = gen.randInt(2, 24);
+        WidestPaths paths;
+        for (int i = 0; i < n; ++i)
+            paths.add("DC" + std::to_string(i + 1), NONE);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                paths.link[i][j] = i == j ? link_weight(1200)
+                                          : random_weight(gen);
+        paths.build();
+
+        for (int step = 0; step < 50; ++step)
+        {
+            int u = gen.randInt(0, n - 1), v = gen.randInt(0, n - 1);
+            if (u == v)
+                continue;
+            auto before = paths.dis;
+            auto changed = paths.setLink(u, v, random_weight(gen));
+
+            WidestPaths floyd = paths;
+            floyd.build();
+            if (!same(paths, floyd))
+            {
+                std::cout << "round " << round << " step " << step
+                          << ": dis differs from build()\n";
+                failed++;
+                break;
+            }
+            // exactly the pairs whose value changed
+            set<pair<int, int>> expect, got(changed.begin(), changed.end());
+            for (int i = 0; i < n; ++i)
+                for (int j = 0; j < n; ++j)
+                    if (before[i][j] != paths.dis[i][j])
+                        expect.emplace(i, j);
+            if (expect != got)
+            {
+                std::cout << "round " << round << " step " << step
+                          << ": changed pairs differ\n";
+                failed++;
+                break;
+            }
+        }
+    }
+    std::cout << (failed ? "FAILED" : "PASSED") << std::endl;
+    return failed ? 1 : 0;
+}